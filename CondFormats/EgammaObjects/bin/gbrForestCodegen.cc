@@ -0,0 +1,44 @@
+// Write the compiled version of a GBRForest stored in a ROOT file, to be
+// added to the library of the module using it through GBRForestEvaluator:
+//
+//   gbrForestCodegen <file.root> <forest name> <output.cc>
+//
+// The generated file must not be compiled with -ffast-math, which would
+// allow the responses of the trees to be summed in a different order.
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
+
+#include "TFile.h"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+int main(int argc, char** argv) {
+  if (argc!=4) {
+    std::cerr << "usage: " << argv[0] << " <file.root> <forest name> <output.cc>" << std::endl;
+    return 1;
+  }
+
+  TFile file(argv[1]);
+  if (file.IsZombie()) {
+    std::cerr << "cannot open " << argv[1] << std::endl;
+    return 1;
+  }
+  std::unique_ptr<GBRForest> forest((GBRForest*)file.Get(argv[2]));
+  if (!forest) {
+    std::cerr << "no GBRForest " << argv[2] << " in " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::ofstream out(argv[3]);
+  GBRForestEvaluator::GenerateCode(*forest, out, std::string(argv[2])+" in "+argv[1]);
+  if (!out) {
+    std::cerr << "cannot write " << argv[3] << std::endl;
+    return 1;
+  }
+  std::cout << "forest " << argv[2] << " with " << forest->Trees().size() << " trees, digest "
+            << GBRForestEvaluator::ForestDigest(*forest) << std::endl;
+  return 0;
+}
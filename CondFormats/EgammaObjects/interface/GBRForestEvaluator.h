@@ -0,0 +1,75 @@
+#ifndef EGAMMAOBJECTS_GBRForestEvaluator
+#define EGAMMAOBJECTS_GBRForestEvaluator
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// GBRForestEvaluator                                                   //
+//                                                                      //
+// Drop-in replacement for the evaluation of a GBRForest which uses a   //
+// compiled version of the forest when one is available.                //
+//                                                                      //
+// The compiled versions are C++ files written by gbrForestCodegen,     //
+// which register their response function under the digest of the      //
+// payload they were generated from when their library is loaded. The  //
+// evaluator computes the digest of the forest it is given and falls    //
+// back to a GBRForestFlat when no compiled version matches it.         //
+// Both give bit-identical results to GBRForest::GetResponse.           //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "CondFormats/EgammaObjects/interface/GBRForestFlat.h"
+
+#include <cmath>
+#include <ostream>
+#include <string>
+
+class GBRForest;
+
+class GBRForestEvaluator {
+
+  public:
+
+    typedef double (*ResponseFunction)(const float* vector);
+
+    GBRForestEvaluator() {}
+    explicit GBRForestEvaluator(const GBRForest &forest);
+
+    double GetResponse(const float* vector) const;
+    double GetGradBoostClassifier(const float* vector) const;
+
+    /// responses of n candidates, the variables of candidate i starting at vectors[i*stride]
+    void GetResponses(const float* vectors, unsigned int n, unsigned int stride, double* responses) const;
+
+    /// a compiled version of the forest is used
+    bool IsCompiled() const { return fCompiled!=nullptr; }
+    const std::string &Digest() const { return fDigest; }
+
+    /// digest of the content of a forest, the key of its compiled version
+    static std::string ForestDigest(const GBRForest &forest);
+
+    /// write the C++ code of the compiled version of a forest
+    static void GenerateCode(const GBRForest &forest, std::ostream &out, const std::string &comment);
+
+    /// register the response function of a compiled forest, done by the generated code
+    struct Registrar {
+      Registrar(const char* digest, ResponseFunction response);
+    };
+
+  private:
+    std::string      fDigest;
+    ResponseFunction fCompiled = nullptr;
+    GBRForestFlat    fFlat;
+};
+
+//_______________________________________________________________________
+inline double GBRForestEvaluator::GetResponse(const float* vector) const {
+  return fCompiled ? fCompiled(vector) : fFlat.GetResponse(vector);
+}
+
+//_______________________________________________________________________
+inline double GBRForestEvaluator::GetGradBoostClassifier(const float* vector) const {
+  double response = GetResponse(vector);
+  return 2.0/(1.0+exp(-2.0*response))-1; //MVA output between -1 and 1
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef EGAMMAOBJECTS_GBRForestFlat
+#define EGAMMAOBJECTS_GBRForestFlat
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// GBRForestFlat                                                        //
+//                                                                      //
+// Transient copy of a GBRForest laid out for evaluating many           //
+// candidates at once: the nodes of all trees are packed in a single    //
+// array of 16 byte records (cut, variable, daughters), so that one     //
+// cache line holds four nodes, and each tree is evaluated for a block  //
+// of candidates before moving to the next one.                         //
+//                                                                      //
+// The candidates of a block descend the tree in lockstep for as many   //
+// steps as the depth of the tree, without branches on the path taken.  //
+// The responses are accumulated tree by tree in the same order as      //
+// GBRForest::GetResponse, so the results are bit-identical to it.      //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cmath>
+
+class GBRForest;
+
+class GBRForestFlat {
+
+  public:
+
+    struct Node {
+      float cut;
+      int   var;
+      int   left;   // > 0: index of a node, <= 0: minus the index of a leaf
+      int   right;
+    };
+
+    GBRForestFlat() {}
+    explicit GBRForestFlat(const GBRForest &forest);
+
+    double GetResponse(const float* vector) const;
+    double GetGradBoostClassifier(const float* vector) const;
+
+    /// responses of n candidates, the variables of candidate i starting at vectors[i*stride]
+    void GetResponses(const float* vectors, unsigned int n, unsigned int stride, double* responses) const;
+    void GetGradBoostClassifiers(const float* vectors, unsigned int n, unsigned int stride, double* responses) const;
+
+    unsigned int NTrees() const { return fRoots.size(); }
+    bool empty() const { return fRoots.empty(); }
+
+    /// number of candidates evaluated together
+    static constexpr unsigned int kBlock = 16;
+
+  private:
+    void EvalBlock(const float* vectors, unsigned int n, unsigned int stride, double* responses) const;
+
+    double            fInitialResponse = 0.;
+    std::vector<Node> fNodes;
+    std::vector<float> fLeaves;
+    std::vector<int>  fRoots;
+    std::vector<unsigned int> fDepths;  // number of cuts on the longest path
+};
+
+//_______________________________________________________________________
+inline double GBRForestFlat::GetResponse(const float* vector) const {
+  double response = fInitialResponse;
+  for (unsigned int it=0; it<fRoots.size(); ++it) {
+    int index = fRoots[it];
+    do {
+      auto const & node = fNodes[index];
+      index = vector[node.var] > node.cut ? node.right : node.left;
+    } while (index>0);
+    response += fLeaves[-index];
+  }
+  return response;
+}
+
+//_______________________________________________________________________
+inline double GBRForestFlat::GetGradBoostClassifier(const float* vector) const {
+  double response = GetResponse(vector);
+  return 2.0/(1.0+exp(-2.0*response))-1; //MVA output between -1 and 1
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "FWCore/Utilities/interface/Digest.h"
+
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace {
+  // the compiled forests register themselves when their library is loaded,
+  // possibly while other threads are building evaluators
+  std::mutex registryMutex;
+
+  std::map<std::string, GBRForestEvaluator::ResponseFunction> & registry() {
+    static std::map<std::string, GBRForestEvaluator::ResponseFunction> compiled;
+    return compiled;
+  }
+
+  template<typename T>
+  void append(cms::Digest &digest, const std::vector<T> &v) {
+    unsigned int size = v.size();
+    digest.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    digest.append(reinterpret_cast<const char*>(v.data()), v.size()*sizeof(T));
+  }
+
+  // literals which are read back as the same float
+  std::string literal(float value) {
+    if (std::isinf(value))
+      return value>0 ? "std::numeric_limits<float>::infinity()" : "-std::numeric_limits<float>::infinity()";
+    std::ostringstream s;
+    s << std::scientific << std::setprecision(std::numeric_limits<float>::max_digits10-1) << value << 'f';
+    return s.str();
+  }
+
+  void generateNode(const GBRTree &tree, int index, unsigned int depth, std::ostream &out) {
+    std::string indent(2*depth,' ');
+    auto daughter = [&](int d) {
+      if (d>0) generateNode(tree,d,depth+1,out);
+      else out << indent << "  r += " << literal(tree.Responses()[-d]) << ";\n";
+    };
+    out << indent << "if (x[" << int(tree.CutIndices()[index]) << "] > " << literal(tree.CutVals()[index]) << ") {\n";
+    daughter(tree.RightIndices()[index]);
+    out << indent << "} else {\n";
+    daughter(tree.LeftIndices()[index]);
+    out << indent << "}\n";
+  }
+}
+
+//_______________________________________________________________________
+GBRForestEvaluator::GBRForestEvaluator(const GBRForest &forest) :
+  fDigest(ForestDigest(forest))
+{
+  {
+    std::lock_guard<std::mutex> guard(registryMutex);
+    auto found = registry().find(fDigest);
+    if (found!=registry().end()) fCompiled = found->second;
+  }
+  if (!fCompiled) fFlat = GBRForestFlat(forest);
+}
+
+//_______________________________________________________________________
+void GBRForestEvaluator::GetResponses(const float* vectors, unsigned int n, unsigned int stride, double* responses) const {
+  if (fCompiled) {
+    for (unsigned int i=0; i<n; ++i) responses[i] = fCompiled(vectors+i*stride);
+  } else {
+    fFlat.GetResponses(vectors, n, stride, responses);
+  }
+}
+
+//_______________________________________________________________________
+std::string GBRForestEvaluator::ForestDigest(const GBRForest &forest) {
+  cms::Digest digest;
+  double initial = forest.InitialResponse();
+  digest.append(reinterpret_cast<const char*>(&initial), sizeof(initial));
+  for (auto const & tree : forest.Trees()) {
+    append(digest,tree.CutIndices());
+    append(digest,tree.CutVals());
+    append(digest,tree.LeftIndices());
+    append(digest,tree.RightIndices());
+    append(digest,tree.Responses());
+  }
+  return digest.digest().toString();
+}
+
+//_______________________________________________________________________
+void GBRForestEvaluator::GenerateCode(const GBRForest &forest, std::ostream &out, const std::string &comment) {
+  auto digest = ForestDigest(forest);
+  out << "// Generated by gbrForestCodegen from " << comment << "\n"
+      << "// Do not edit: regenerate it when the payload changes, the digest would no longer match.\n"
+      << "// Do not compile it with -ffast-math, the trees must be summed in order.\n\n"
+      << "#include \"CondFormats/EgammaObjects/interface/GBRForestEvaluator.h\"\n\n"
+      << "#include <limits>\n\n"
+      << "namespace {\n\n"
+      << "double response(const float* x) {\n"
+      << std::scientific << std::setprecision(std::numeric_limits<double>::max_digits10-1)
+      << "  double r = " << forest.InitialResponse() << ";\n";
+  for (unsigned int it=0; it<forest.Trees().size(); ++it) {
+    out << "  // tree " << it << "\n";
+    generateNode(forest.Trees()[it],0,1,out);
+  }
+  out << "  return r;\n"
+      << "}\n\n"
+      << "GBRForestEvaluator::Registrar registrar(\"" << digest << "\", &response);\n\n"
+      << "}\n";
+}
+
+//_______________________________________________________________________
+GBRForestEvaluator::Registrar::Registrar(const char* digest, ResponseFunction response) {
+  std::lock_guard<std::mutex> guard(registryMutex);
+  registry()[digest] = response;
+}
@@ -0,0 +1,79 @@
+#include "CondFormats/EgammaObjects/interface/GBRForestFlat.h"
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+
+#include <algorithm>
+
+namespace {
+  // number of cuts on the longest path from node index of the tree,
+  // where a daughter index <= 0 is a leaf and the root is node 0
+  unsigned int depth(const GBRTree &tree, int index) {
+    int left = tree.LeftIndices()[index], right = tree.RightIndices()[index];
+    return 1+std::max(left>0 ? depth(tree,left) : 0U, right>0 ? depth(tree,right) : 0U);
+  }
+}
+
+//_______________________________________________________________________
+GBRForestFlat::GBRForestFlat(const GBRForest &forest) :
+  fInitialResponse(forest.InitialResponse())
+{
+  unsigned int nnodes = 0, nleaves = 0;
+  for (auto const & tree : forest.Trees()) {
+    nnodes += tree.CutIndices().size();
+    nleaves += tree.Responses().size();
+  }
+  // node 0 is never a daughter, so it is used as a dummy node: the daughter
+  // indices of all the other nodes are then strictly positive
+  fNodes.reserve(nnodes+1);
+  fNodes.push_back(Node{0.f,0,0,0});
+  fLeaves.reserve(nleaves);
+  fRoots.reserve(forest.Trees().size());
+  fDepths.reserve(forest.Trees().size());
+
+  for (auto const & tree : forest.Trees()) {
+    int nodeOffset = fNodes.size();
+    int leafOffset = fLeaves.size();
+    auto daughter = [&](int index) { return index>0 ? nodeOffset+index : -leafOffset+index; };
+    for (unsigned int i=0; i<tree.CutIndices().size(); ++i)
+      fNodes.push_back(Node{tree.CutVals()[i], tree.CutIndices()[i],
+                            daughter(tree.LeftIndices()[i]), daughter(tree.RightIndices()[i])});
+    fLeaves.insert(fLeaves.end(),tree.Responses().begin(),tree.Responses().end());
+    fRoots.push_back(nodeOffset);
+    fDepths.push_back(depth(tree,0));
+  }
+}
+
+//_______________________________________________________________________
+void GBRForestFlat::EvalBlock(const float* vectors, unsigned int n, unsigned int stride, double* responses) const {
+  int index[kBlock];
+  for (unsigned int i=0; i<n; ++i) responses[i] = fInitialResponse;
+
+  for (unsigned int it=0; it<fRoots.size(); ++it) {
+    auto const & root = fNodes[fRoots[it]];
+    for (unsigned int i=0; i<n; ++i)
+      index[i] = vectors[i*stride+root.var] > root.cut ? root.right : root.left;
+    // candidates that reached a leaf stay there, looking at the dummy node
+    for (unsigned int d=1; d<fDepths[it]; ++d) {
+      for (unsigned int i=0; i<n; ++i) {
+        int current = index[i];
+        auto const & node = fNodes[std::max(current,0)];
+        int next = vectors[i*stride+node.var] > node.cut ? node.right : node.left;
+        index[i] = current>0 ? next : current;
+      }
+    }
+    for (unsigned int i=0; i<n; ++i)
+      responses[i] += fLeaves[-index[i]];
+  }
+}
+
+//_______________________________________________________________________
+void GBRForestFlat::GetResponses(const float* vectors, unsigned int n, unsigned int stride, double* responses) const {
+  for (unsigned int first=0; first<n; first+=kBlock)
+    EvalBlock(vectors+first*stride, std::min(kBlock,n-first), stride, responses+first);
+}
+
+//_______________________________________________________________________
+void GBRForestFlat::GetGradBoostClassifiers(const float* vectors, unsigned int n, unsigned int stride, double* responses) const {
+  GetResponses(vectors, n, stride, responses);
+  for (unsigned int i=0; i<n; ++i)
+    responses[i] = 2.0/(1.0+exp(-2.0*responses[i]))-1; //MVA output between -1 and 1
+}
@@ -0,0 +1,93 @@
+// Check the digest and the selection between the compiled version and the
+// interpreter in GBRForestEvaluator. testGBRForestEvaluatorCompiled.cc is the
+// output of GenerateCode for makeForest(), linked into this test: regenerate
+// it when makeForest() changes.
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace {
+  constexpr unsigned int nVars = 4;
+
+  GBRForest makeForest() {
+    GBRForest forest;
+    forest.SetInitialResponse(-0.25);
+    for (unsigned int i=0; i<3; ++i) {
+      GBRTree tree;
+      // x[i] > 0.5 ? (x[3] > -0.5 ? leaf 2 : leaf 1) : leaf 0
+      tree.CutIndices() = {(unsigned char)i, 3};
+      tree.CutVals() = {0.5f, -0.5f};
+      tree.LeftIndices() = {0, -1};
+      tree.RightIndices() = {1, -2};
+      tree.Responses() = {0.1f*i, 1.f+i, -2.f*i};
+      forest.Trees().push_back(tree);
+    }
+    return forest;
+  }
+}
+
+int main() {
+  auto forest = makeForest();
+  unsigned int nBad = 0;
+
+  auto modified = forest;
+  modified.Trees()[2].Responses()[1] = 0.f;
+  if (GBRForestEvaluator::ForestDigest(forest)!=GBRForestEvaluator::ForestDigest(makeForest())) {
+    std::cout << "the digest of identical forests differs" << std::endl;
+    ++nBad;
+  }
+  if (GBRForestEvaluator::ForestDigest(forest)==GBRForestEvaluator::ForestDigest(modified)) {
+    std::cout << "the digest does not depend on the responses" << std::endl;
+    ++nBad;
+  }
+
+  std::ostringstream code;
+  GBRForestEvaluator::GenerateCode(forest, code, "testGBRForestEvaluator");
+  if (code.str().find(GBRForestEvaluator::ForestDigest(forest))==std::string::npos) {
+    std::cout << "the generated code does not register the digest" << std::endl;
+    ++nBad;
+  }
+
+  // random inputs, and inputs on the cuts
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<float> var(-1.f,1.f);
+  const unsigned int n = 1000;
+  std::vector<float> vars(n*nVars);
+  for (auto & v : vars) v = var(gen);
+  for (unsigned int i=0; i<nVars; ++i) {
+    vars[i*nVars+i] = 0.5f;
+    vars[i*nVars+3] = -0.5f;
+  }
+  std::vector<double> responses(n);
+
+  // no compiled version for the modified forest: the interpreter is used
+  GBRForestEvaluator interpreted(modified);
+  if (interpreted.IsCompiled()) {
+    std::cout << "a compiled version was found for the modified forest" << std::endl;
+    ++nBad;
+  }
+  interpreted.GetResponses(vars.data(), n, nVars, responses.data());
+  for (unsigned int i=0; i<n; ++i)
+    if (responses[i]!=modified.GetResponse(&vars[i*nVars]) || interpreted.GetResponse(&vars[i*nVars])!=responses[i]) ++nBad;
+
+  // the generated code registered the compiled version of the forest
+  GBRForestEvaluator evaluator(forest);
+  if (!evaluator.IsCompiled()) {
+    std::cout << "the compiled version of the forest is not registered" << std::endl;
+    ++nBad;
+  }
+  evaluator.GetResponses(vars.data(), n, nVars, responses.data());
+  for (unsigned int i=0; i<n; ++i)
+    if (responses[i]!=forest.GetResponse(&vars[i*nVars]) || evaluator.GetResponse(&vars[i*nVars])!=responses[i]) ++nBad;
+
+  if (nBad>0) {
+    std::cout << nBad << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
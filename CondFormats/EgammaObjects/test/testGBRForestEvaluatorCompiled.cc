@@ -0,0 +1,48 @@
+// Generated by gbrForestCodegen from makeForest() in testGBRForestEvaluator.cpp
+// Do not edit: regenerate it when the payload changes, the digest would no longer match.
+// Do not compile it with -ffast-math, the trees must be summed in order.
+
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
+
+#include <limits>
+
+namespace {
+
+double response(const float* x) {
+  double r = -2.5000000000000000e-01;
+  // tree 0
+  if (x[0] > 5.00000000e-01f) {
+    if (x[3] > -5.00000000e-01f) {
+      r += -0.00000000e+00f;
+    } else {
+      r += 1.00000000e+00f;
+    }
+  } else {
+    r += 0.00000000e+00f;
+  }
+  // tree 1
+  if (x[1] > 5.00000000e-01f) {
+    if (x[3] > -5.00000000e-01f) {
+      r += -2.00000000e+00f;
+    } else {
+      r += 2.00000000e+00f;
+    }
+  } else {
+    r += 1.00000001e-01f;
+  }
+  // tree 2
+  if (x[2] > 5.00000000e-01f) {
+    if (x[3] > -5.00000000e-01f) {
+      r += -4.00000000e+00f;
+    } else {
+      r += 3.00000000e+00f;
+    }
+  } else {
+    r += 2.00000003e-01f;
+  }
+  return r;
+}
+
+GBRForestEvaluator::Registrar registrar("1abb54b79855cc70ee0ae547a366d23b", &response);
+
+}
@@ -0,0 +1,100 @@
+// Check that GBRForestFlat gives bit-identical responses to GBRForest on a
+// random forest, and compare the time taken to evaluate a collection.
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CondFormats/EgammaObjects/interface/GBRForestFlat.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  constexpr unsigned int nVars = 16;
+
+  std::mt19937 gen(42);
+
+  // add a random subtree and return its index as a daughter of its parent
+  int addNode(GBRTree & tree, unsigned int depth) {
+    std::uniform_real_distribution<float> cut(-1.f,1.f);
+    std::bernoulli_distribution stop(0.2);
+    if (depth==0 || (tree.CutIndices().size()>1 && stop(gen))) {
+      tree.Responses().push_back(cut(gen));
+      return 1-int(tree.Responses().size());
+    }
+    int index = tree.CutIndices().size();
+    tree.CutIndices().push_back(gen()%nVars);
+    tree.CutVals().push_back(cut(gen));
+    tree.LeftIndices().push_back(0);
+    tree.RightIndices().push_back(0);
+    int left = addNode(tree,depth-1);
+    int right = addNode(tree,depth-1);
+    tree.LeftIndices()[index] = left;
+    tree.RightIndices()[index] = right;
+    return index;
+  }
+
+  GBRForest makeForest(unsigned int nTrees, unsigned int maxDepth) {
+    GBRForest forest;
+    forest.SetInitialResponse(0.1);
+    for (unsigned int i=0; i<nTrees; ++i) {
+      GBRTree tree;
+      if (i==0) {
+        // a tree made of a single leaf
+        tree.CutIndices().push_back(0);
+        tree.CutVals().push_back(0);
+        tree.LeftIndices().push_back(0);
+        tree.RightIndices().push_back(0);
+        tree.Responses().push_back(0.5f);
+      } else {
+        addNode(tree,1+gen()%maxDepth);
+      }
+      forest.Trees().push_back(tree);
+    }
+    return forest;
+  }
+}
+
+int main() {
+  auto forest = makeForest(500,6);
+  GBRForestFlat flat(forest);
+
+  unsigned int nCand = 10003;
+  std::uniform_real_distribution<float> var(-1.2f,1.2f);
+  std::vector<float> vars(nCand*nVars);
+  for (auto & v : vars) v = var(gen);
+  // values exactly on the cuts
+  for (unsigned int i=0; i<nVars; ++i)
+    vars[i] = forest.Trees()[1].CutVals()[0];
+
+  std::vector<double> ref(nCand), single(nCand), batch(nCand);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned int i=0; i<nCand; ++i) ref[i] = forest.GetResponse(&vars[i*nVars]);
+  auto t1 = std::chrono::steady_clock::now();
+  for (unsigned int i=0; i<nCand; ++i) single[i] = flat.GetResponse(&vars[i*nVars]);
+  auto t2 = std::chrono::steady_clock::now();
+  flat.GetResponses(vars.data(),nCand,nVars,batch.data());
+  auto t3 = std::chrono::steady_clock::now();
+
+  unsigned int nBad = 0;
+  for (unsigned int i=0; i<nCand; ++i)
+    if (single[i]!=ref[i] || batch[i]!=ref[i]) ++nBad;
+
+  std::vector<double> cls(nCand);
+  flat.GetGradBoostClassifiers(vars.data(),nCand,nVars,cls.data());
+  for (unsigned int i=0; i<nCand; ++i)
+    if (cls[i]!=forest.GetGradBoostClassifier(&vars[i*nVars])) ++nBad;
+
+  auto us = [](auto a, auto b) { return std::chrono::duration_cast<std::chrono::microseconds>(b-a).count(); };
+  std::cout << nCand << " candidates, " << forest.Trees().size() << " trees:"
+            << " GBRForest " << us(t0,t1) << " us,"
+            << " GBRForestFlat " << us(t1,t2) << " us,"
+            << " GBRForestFlat batch " << us(t2,t3) << " us" << std::endl;
+
+  if (nBad>0) {
+    std::cout << nBad << " responses differ from GBRForest" << std::endl;
+    return 1;
+  }
+  return 0;
+}
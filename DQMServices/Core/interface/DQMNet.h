@@ -316,6 +316,7 @@ protected:
   static void		discard(Bucket *&b);
 
   bool			debug_;
+  bool			flushAll_;
   pthread_mutex_t	lock_;
 
 private:
@@ -466,6 +467,7 @@ protected:
     }
 
   // Mark remaining zombie objects as dead.  See markObjectsDead().
+  // Removing objects forces the next flush to send the full list.
   void
   purgeDeadObjects(Peer *p) override
     {
@@ -474,7 +476,10 @@ protected:
       for (i = ip->objs.begin(), e = ip->objs.end(); i != e; )
       {
 	if (i->flags & DQM_PROP_DEAD)
+	{
 	  ip->objs.erase(i++);
+	  flushAll_ = true;
+	}
 	else
 	  ++i;
       }
@@ -518,9 +523,13 @@ protected:
       peers_.erase(s);
 
       // If we removed a peer with objects, our list of objects
-      // has changed and we need to update downstream peers.
+      // has changed and we need to send downstream peers a full
+      // list so they can purge the vanished objects.
       if (needflush)
+      {
+	flushAll_ = true;
 	sendLocalChanges();
+      }
     }
 
   /// Send all objects to a peer and optionally mark sent objects old.
@@ -580,7 +589,7 @@ protected:
 
 	Bucket msg;
         msg.next = nullptr;
-	sendObjectListToPeer(&msg, !p.updated || all, true);
+	sendObjectListToPeer(&msg, !p.updated || all, false);
 
 	if (! msg.data.empty())
 	{
@@ -594,6 +603,12 @@ protected:
 	}
 	p.updated = true;
       }
+
+      // Only now mark the objects old, so that every peer receiving
+      // incremental updates sees the same set of changed objects.
+      for (i = peers_.begin(), e = peers_.end(); i != e; ++i)
+	for (oi = i->second.objs.begin(), oe = i->second.objs.end(); oi != oe; ++oi)
+	  const_cast<ObjType &>(*oi).flags &= ~DQM_PROP_NEW;
     }
 
   void
@@ -418,20 +418,24 @@ void
 DQMNet::sendObjectToPeer(Bucket *msg, Object &o, bool data)
 {
   uint32_t flags = o.flags & ~DQM_PROP_DEAD;
-  DataBlob objdata;
 
+  // Copy the payload straight from the object into the message,
+  // there is no need to stage it in an intermediate buffer.
+  const void *objdata = nullptr;
+  uint32_t datalen = 0;
   if ((flags & DQM_PROP_TYPE_MASK) <= DQM_PROP_TYPE_SCALAR)
-    objdata.insert(objdata.end(),
-		   &o.scalar[0],
-		   &o.scalar[0] + o.scalar.size());
-  else if (data)
-    objdata.insert(objdata.end(),
-		   &o.rawdata[0],
-		   &o.rawdata[0] + o.rawdata.size());
+  {
+    objdata = o.scalar.data();
+    datalen = o.scalar.size();
+  }
+  else if (data && ! o.rawdata.empty())
+  {
+    objdata = &o.rawdata[0];
+    datalen = o.rawdata.size();
+  }
 
   uint32_t words [9];
   uint32_t namelen = o.dirname->size() + o.objname.size() + 1;
-  uint32_t datalen = objdata.size();
   uint32_t qlen = o.qdata.size();
 
   if (o.dirname->empty())
@@ -457,7 +461,7 @@ DQMNet::sendObjectToPeer(Bucket *msg, Object &o, bool data)
     copydata(msg, &o.objname[0], o.objname.size());
   }
   if (datalen)
-    copydata(msg, &objdata[0], datalen);
+    copydata(msg, objdata, datalen);
   if (qlen)
     copydata(msg, &o.qdata[0], qlen);
 }
@@ -1068,6 +1072,7 @@ DQMNet::updateMask(Peer *p)
 //////////////////////////////////////////////////////////////////////
 DQMNet::DQMNet (const std::string &appname /* = "" */)
   : debug_ (false),
+    flushAll_ (true),
     appname_ (appname.empty() ? "DQMNet" : appname.c_str()),
     pid_ (getpid()),
     server_ (nullptr),
@@ -1376,13 +1381,17 @@ DQMNet::run()
     now = Time::current();
     lock();
 
-    // Check if flush is required.  Flush only if one is needed.
-    // Always sends the full object list, but only rarely.
+    // Check if flush is required.  Flush only if one is needed, and
+    // only rarely.  Peers which already have our object list receive
+    // just the objects which changed since the last flush; the full
+    // list is sent only when objects have disappeared, so that the
+    // peers get a chance to purge them.
     if (flush_ && now > nextFlush)
     {
       flush_ = false;
       nextFlush = now + TimeSpan(0, 0, 0, 15 /* seconds */, 0);
-      sendObjectListToPeers(true);
+      sendObjectListToPeers(flushAll_);
+      flushAll_ = false;
     }
 
     // Update the data server and peer selection masks.  If we
@@ -1499,5 +1508,8 @@ DQMBasicNet::removeLocalExcept(const std::set<std::string> &known)
       ++i;
   }
 
+  if (removed)
+    flushAll_ = true;
+
   return removed > 0;
 }
@@ -30,6 +30,48 @@ float QCriterion::runTest(const MonitorElement * /* me */)
   raiseDQMError("QCriterion", "virtual runTest method called" );
   return 0.;
 }
+
+// Copy the contents of all cells of @a h, including under- and
+// overflow, into the flat array @a out, indexed like TH1::GetBin().
+// Plain histograms are read straight from their storage array, which
+// gives exactly the values GetBinContent() would return but lets the
+// tests below run tight loops instead of one virtual call per bin.
+// Profiles and buffered histograms go through GetBinContent().
+static void
+binContents(const TH1 *h, std::vector<double> &out)
+{
+  int ncells = h->GetNcells();
+  out.resize(ncells);
+  if (! h->GetBuffer()
+      && ! h->InheritsFrom(TProfile::Class())
+      && ! h->InheritsFrom(TProfile2D::Class()))
+  {
+    if (const TArrayF *a = dynamic_cast<const TArrayF *>(h))
+    {
+      const Float_t *v = a->GetArray();
+      for (int i = 0; i < ncells; ++i)
+	out[i] = v[i];
+      return;
+    }
+    if (const TArrayS *a = dynamic_cast<const TArrayS *>(h))
+    {
+      const Short_t *v = a->GetArray();
+      for (int i = 0; i < ncells; ++i)
+	out[i] = v[i];
+      return;
+    }
+    if (const TArrayD *a = dynamic_cast<const TArrayD *>(h))
+    {
+      const Double_t *v = a->GetArray();
+      for (int i = 0; i < ncells; ++i)
+	out[i] = v[i];
+      return;
+    }
+  }
+
+  for (int i = 0; i < ncells; ++i)
+    out[i] = h->GetBinContent(i);
+}
 //===================================================//
 //================ QUALITY TESTS ====================//
 //==================================================//
@@ -243,11 +285,14 @@ float Comp2RefChi2::runTest(const MonitorElement *me)
   ndof = i_end-i_start+1-constraint;
 
   //Compute the normalisation factor
+  std::vector<double> cont1, cont2;
+  binContents(h, cont1);
+  binContents(ref_, cont2);
   double sum1=0, sum2=0;
   for (i=i_start; i<=i_end; i++)
   {
-    sum1 += h->GetBinContent(i);
-    sum2 += ref_->GetBinContent(i);
+    sum1 += cont1[i];
+    sum2 += cont2[i];
   }
 
   //check that the histograms are not empty
@@ -271,8 +316,8 @@ float Comp2RefChi2::runTest(const MonitorElement *me)
   double bin1, bin2, err1, err2, temp;
   for (i=i_start; i<=i_end; i++)
   {
-    bin1 = h->GetBinContent(i)/sum1;
-    bin2 = ref_->GetBinContent(i)/sum2;
+    bin1 = cont1[i]/sum1;
+    bin2 = cont2[i]/sum2;
     if (bin1 ==0 && bin2==0)
     {
       --ndof; //no data means one less degree of freedom
@@ -639,9 +684,11 @@ float ContentsXRange::runTest(const MonitorElement*me)
   // entries outside X-range
   double fail = 0;
   int bin;
+  std::vector<double> cont;
+  binContents(h, cont);
   for (bin = first; bin <= last; ++bin)
   {
-    double contents = h->GetBinContent(bin);
+    double contents = cont[bin];
     double x = h->GetBinCenter(bin);
     sum += contents;
     if (x < xmin_ || x > xmax_)fail += contents;
@@ -700,12 +747,14 @@ float ContentsYRange::runTest(const MonitorElement*me)
   // bins outside Y-range
   int fail = 0;
   int bin;
+  std::vector<double> cont;
+  binContents(h, cont);
   
   if (useEmptyBins_)///Standard test !
   {
     for (bin = first; bin <= last; ++bin)
     {
-      double contents = h->GetBinContent(bin);
+      double contents = cont[bin];
       bool failure = false;
       failure = (contents < ymin_ || contents > ymax_); // allowed y-range: [ymin_, ymax_]
       if (failure) 
@@ -722,7 +771,7 @@ float ContentsYRange::runTest(const MonitorElement*me)
   {
     for (bin = first; bin <= last; ++bin)
     {
-      double contents = h->GetBinContent(bin);
+      double contents = cont[bin];
       bool failure = false;
       if (contents) failure = (contents < ymin_ || contents > ymax_); // allowed y-range: [ymin_, ymax_]
       if (failure) ++fail;
@@ -798,11 +847,13 @@ float DeadChannel::runTest(const MonitorElement*me)
     int first = 1;
     int last  = ncx;
     int bin;
+    std::vector<double> cont;
+    binContents(h1, cont);
 
     /// loop over all channels
     for (bin = first; bin <= last; ++bin)
     {
-      double contents = h1->GetBinContent(bin);
+      double contents = cont[bin];
       bool failure = false;
       failure = contents <= ymin_; // dead channel: equal to or less than ymin_
       if (failure)
@@ -822,13 +873,15 @@ float DeadChannel::runTest(const MonitorElement*me)
   {
     int ncx = h2->GetXaxis()->GetNbins(); // get X bins
     int ncy = h2->GetYaxis()->GetNbins(); // get Y bins
+    std::vector<double> cont;
+    binContents(h2, cont);
 
     /// loop over all bins 
     for (int cx = 1; cx <= ncx; ++cx)
     {
       for (int cy = 1; cy <= ncy; ++cy)
       {
-	double contents = h2->GetBinContent(h2->GetBin(cx, cy));
+	double contents = cont[h2->GetBin(cx, cy)];
 	bool failure = false;
 	failure = contents <= ymin_; // dead channel: equal to or less than ymin_
 	if (failure)
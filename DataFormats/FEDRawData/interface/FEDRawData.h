@@ -50,6 +50,12 @@ class FEDRawData {
   /// the size is a multiple of the size of a FED word (8 bytes)
   void resize(size_t newsize);
 
+  /// Replace the buffer with a copy of the @a newsize bytes starting at
+  /// @a newdata. Unlike resize() followed by a memcpy, the buffer is
+  /// written only once. It is required that the size is a multiple of
+  /// the size of a FED word (8 bytes)
+  void assign(const unsigned char * newdata, size_t newsize);
+
  private:
 
 
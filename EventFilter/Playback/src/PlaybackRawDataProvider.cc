@@ -108,8 +108,7 @@ void PlaybackRawDataProvider::analyze(const Event& iEvent,
     unsigned int fedSize=pRawData->FEDData(i).size();
     if (fedSize>0) {
       FEDRawData& fedData=eventQueue_[writeIndex_]->FEDData(i);
-      fedData.resize(fedSize);
-      memcpy(fedData.data(),pRawData->FEDData(i).data(),fedSize);
+      fedData.assign(pRawData->FEDData(i).data(),fedSize);
     }
   }
   
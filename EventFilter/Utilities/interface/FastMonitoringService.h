@@ -16,6 +16,8 @@
 #include "EventFilter/Utilities/interface/MicroStateService.h"
 #include "EventFilter/Utilities/interface/FastMonitoringThread.h"
 
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <map>
@@ -188,10 +190,49 @@ namespace evf{
       void setInState(FastMonitoringThread::InputState inputState) {inputState_=inputState;}
       void setInStateSup(FastMonitoringThread::InputState inputState) {inputSupervisorState_=inputState;}
 
+      //header of the binary microstate record files written per stream and lumi when microstateRecordSize is set.
+      //It is followed by nRecords_ MicrostateFileRecord entries, oldest first
+      struct MicrostateFileHeader {
+        char magic_[8];        //"EVFMSREC"
+        uint32_t version_;
+        uint32_t stream_;
+        uint32_t run_;
+        uint32_t lumi_;
+        uint64_t nRecords_;
+        uint64_t dropped_;     //transitions lost because the ring buffer wrapped
+        uint64_t wallClockNs_; //wall clock time of the steady clock origin, for converting record times
+      };
+      //kinds of records: stream transitions follow each other, while the begin and end records of the
+      //modules of a stream can interleave, since modules of one stream can run concurrently
+      enum MicrostateRecordKind { mrStream = 0, mrModuleBegin = 1, mrModuleEnd = 2 };
+      struct MicrostateFileRecord {
+        uint64_t timeNs_;      //steady clock time of the transition
+        int32_t microstate_;   //index into the module legend
+        int32_t ministate_;    //index into the path legend
+        uint32_t kind_;        //MicrostateRecordKind
+        uint32_t reserved_;
+      };
+
     private:
 
       void doSnapshot(const unsigned int ls, const bool isGlobalEOL);
 
+      //record a microstate transition of a stream. Modules of one stream can run concurrently,
+      //so the states are passed by the caller rather than read back from microstate_ and ministate_,
+      //and slots are claimed atomically; the buffer is only read at end of lumi when the stream is idle
+      void recordMicrostate(unsigned int sid, const void* microstate, const void* ministate,
+                            MicrostateRecordKind kind = mrStream) {
+        if (!microstateRecordSize_) return;
+        MicrostateRecorder & rec = microstateRecorders_[sid];
+        uint64_t slot = rec.count_.fetch_add(1,std::memory_order_relaxed);
+        MicrostateRecord & r = rec.records_[slot % microstateRecordSize_];
+        r.time_ = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        r.microstate_ = microstate;
+        r.ministate_ = ministate;
+        r.kind_ = kind;
+      }
+      void writeMicrostateRecords(unsigned int run, unsigned int ls, unsigned int sid);
+
       void doStreamEOLSnapshot(const unsigned int ls, const unsigned int streamID) {
 	//pick up only event count here
 	fmt_.jsonMonitor_->snapStreamAtomic(ls,streamID);
@@ -274,6 +315,22 @@ namespace evf{
       std::vector<ContainableAtomic<const void*>> microstate_;
       std::vector<ContainableAtomic<const void*>> threadMicrostate_;
 
+      //per stream microstate transition recording
+      struct MicrostateRecord {
+        uint64_t time_;
+        const void* microstate_;
+        const void* ministate_;
+        MicrostateRecordKind kind_;
+      };
+      struct MicrostateRecorder {
+        MicrostateRecorder(unsigned int size): records_(size), count_(0) {}
+        MicrostateRecorder(MicrostateRecorder const& other): records_(other.records_), count_(other.count_.load()) {}
+        std::vector<MicrostateRecord> records_;
+        std::atomic<uint64_t> count_;
+      };
+      unsigned int microstateRecordSize_;
+      std::vector<MicrostateRecorder> microstateRecorders_;
+
       //variables measuring source statistics (global)
       //unordered_map is not used because of very few elements stored concurrently
       std::map<unsigned int, double> avgLeadTime_;
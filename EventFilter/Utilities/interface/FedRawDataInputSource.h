@@ -22,6 +22,7 @@
 
 #include "DataFormats/Provenance/interface/LuminosityBlockAuxiliary.h"
 
+class FEDRawData;
 class FEDRawDataCollection;
 class InputSourceDescription;
 class ParameterSet;
@@ -125,6 +126,16 @@ private:
 
   jsoncollector::DataPointDefinition *dpd_;
 
+  //FED fragments located in the current event, copied after the event is fully parsed
+  struct FedFragment {
+    FEDRawData* fedData;
+    const unsigned char* data;
+    uint32_t size;
+  };
+  std::vector<FedFragment> fedFragments_;
+  //events at least this large (in bytes) have their fragments copied in parallel
+  static constexpr uint32_t parallelCopyThreshold_ = 4 << 20;
+
   /*
    *
    * Multithreaded file reader
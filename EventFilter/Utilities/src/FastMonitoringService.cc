@@ -3,6 +3,9 @@
 
 #include "FWCore/Framework/interface/Event.h"
 #include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <sys/time.h>
 
 #include "FWCore/ServiceRegistry/interface/Service.h"
@@ -17,6 +20,7 @@
 #include "FWCore/Utilities/interface/UnixSignalHandlers.h"
 
 #include "FWCore/ServiceRegistry/interface/ModuleCallingContext.h"
+#include "FWCore/ServiceRegistry/interface/PlaceInPathContext.h"
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
 using namespace jsoncollector;
 
@@ -67,6 +71,7 @@ namespace evf{
     ,fastName_("fastmoni")
     ,slowName_("slowmoni")
     ,filePerFwkStream_(iPS.getUntrackedParameter<bool>("filePerFwkStream", false))
+    ,microstateRecordSize_(iPS.getUntrackedParameter<unsigned int>("microstateRecordSize", 0))
     ,totalEventsProcessed_(0)
   {
     reg.watchPreallocate(this, &FastMonitoringService::preallocate);//receiving information on number of threads
@@ -128,6 +133,7 @@ namespace evf{
     desc.addUntracked<int> ("sleepTime",1)->setComment("Sleep time of the monitoring thread");
     desc.addUntracked<unsigned int> ("fastMonIntervals",2)->setComment("Modulo of sleepTime intervals on which fastmon file is written out");
     desc.addUntracked<bool> ("filePerFwkStream", false)->setComment("Switches on monitoring output per framework stream");
+    desc.addUntracked<unsigned int> ("microstateRecordSize", 0)->setComment("Number of microstate transitions buffered per stream and written to a binary file at the end of each lumi. 0 disables recording");
     desc.setAllowAnything();
     descriptions.add("FastMonitoringService", desc);
   }
@@ -268,6 +274,8 @@ namespace evf{
        firstEventId_.push_back(0);
        collectedPathList_.push_back(new std::atomic<bool>(false));
 
+       if (microstateRecordSize_)
+         microstateRecorders_.emplace_back(microstateRecordSize_);
     }
     //for (unsigned int i=0;i<nThreads_;i++)
     //  threadMicrostate_.push_back(&reservedMicroStateNames[mInvalid]);
@@ -517,11 +525,13 @@ namespace evf{
 
     ministate_[sid]=&nopath_;
     microstate_[sid]=&reservedMicroStateNames[mBoL];
+    recordMicrostate(sid,&reservedMicroStateNames[mBoL],&nopath_);
   }
 
   void FastMonitoringService::postStreamBeginLumi(edm::StreamContext const& sc)
   {
     microstate_[sc.streamID().value()]=&reservedMicroStateNames[mIdle];
+    recordMicrostate(sc.streamID().value(),&reservedMicroStateNames[mIdle],&nopath_);
   }
 
   void FastMonitoringService::preStreamEndLumi(edm::StreamContext const& sc)
@@ -534,10 +544,15 @@ namespace evf{
     //reset this in case stream does not get notified of next lumi (we keep processed events only)
     ministate_[sid]=&nopath_;
     microstate_[sid]=&reservedMicroStateNames[mEoL];
+    recordMicrostate(sid,&reservedMicroStateNames[mEoL],&nopath_);
+    //no module of this stream is running now, so the recorded transitions can be written out
+    if (microstateRecordSize_)
+      writeMicrostateRecords(sc.eventID().run(),sc.eventID().luminosityBlock(),sid);
   }
   void FastMonitoringService::postStreamEndLumi(edm::StreamContext const& sc)
   {
     microstate_[sc.streamID().value()]=&reservedMicroStateNames[mFwkEoL];
+    recordMicrostate(sc.streamID().value(),&reservedMicroStateNames[mFwkEoL],&nopath_);
   }
 
 
@@ -570,6 +585,8 @@ namespace evf{
     }
     else {
       ministate_[sc.streamID()] = &(pc.pathName());
+      //time spent in the path outside of its modules is framework overhead
+      recordMicrostate(sc.streamID(),&reservedMicroStateNames[mFwkOvhMod],&(pc.pathName()));
     }
   }
 
@@ -583,6 +600,7 @@ namespace evf{
     microstate_[sc.streamID()] = &reservedMicroStateNames[mIdle];
 
     ministate_[sc.streamID()] = &nopath_;
+    recordMicrostate(sc.streamID(),&reservedMicroStateNames[mIdle],&nopath_);
 
     (*(fmt_.m_data.processed_[sc.streamID()]))++;
     eventCountForPathInit_[sc.streamID()].m_value++;
@@ -596,22 +614,36 @@ namespace evf{
   void FastMonitoringService::preSourceEvent(edm::StreamID sid)
   {
     microstate_[sid.value()] = &reservedMicroStateNames[mInput];
+    recordMicrostate(sid.value(),&reservedMicroStateNames[mInput],&nopath_);
   }
 
   void FastMonitoringService::postSourceEvent(edm::StreamID sid)
   {
     microstate_[sid.value()] = &reservedMicroStateNames[mFwkOvhSrc];
+    recordMicrostate(sid.value(),&reservedMicroStateNames[mFwkOvhSrc],&nopath_);
+  }
+
+  namespace {
+    //path in which a module runs, as recorded in the microstate records; unscheduled modules have none
+    const void* modulePath(edm::ModuleCallingContext const& mcc) {
+      edm::PlaceInPathContext const* place = mcc.placeInPathContext();
+      if (place && place->pathContext())
+        return &(place->pathContext()->pathName());
+      return &FastMonitoringService::nopath_;
+    }
   }
 
   void FastMonitoringService::preModuleEvent(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
   {
     microstate_[sc.streamID().value()] = (void*)(mcc.moduleDescription());
+    recordMicrostate(sc.streamID().value(),mcc.moduleDescription(),modulePath(mcc),mrModuleBegin);
   }
 
   void FastMonitoringService::postModuleEvent(edm::StreamContext const& sc, edm::ModuleCallingContext const& mcc)
   {
     //microstate_[sc.streamID().value()] = (void*)(mcc.moduleDescription());
     microstate_[sc.streamID().value()] = &reservedMicroStateNames[mFwkOvhMod];
+    recordMicrostate(sc.streamID().value(),mcc.moduleDescription(),modulePath(mcc),mrModuleEnd);
   }
 
   //FUNCTIONS CALLED FROM OUTSIDE
@@ -628,6 +660,7 @@ namespace evf{
   void FastMonitoringService::setMicroState(edm::StreamID sid, MicroStateService::Microstate m)
   {
     microstate_[sid] = &reservedMicroStateNames[m];
+    recordMicrostate(sid,&reservedMicroStateNames[m],ministate_[sid]);
   }
 
   //from source
@@ -715,6 +748,49 @@ namespace evf{
     }
   }
 
+  void FastMonitoringService::writeMicrostateRecords(unsigned int run, unsigned int ls, unsigned int sid) {
+    MicrostateRecorder & rec = microstateRecorders_[sid];
+    uint64_t count = rec.count_.exchange(0,std::memory_order_acquire);
+    uint64_t nRecords = std::min<uint64_t>(count,microstateRecordSize_);
+
+    MicrostateFileHeader header;
+    memcpy(header.magic_,"EVFMSREC",sizeof(header.magic_));
+    header.version_ = 2;
+    header.stream_ = sid;
+    header.run_ = run;
+    header.lumi_ = ls;
+    header.nRecords_ = nRecords;
+    header.dropped_ = count - nRecords;
+    header.wallClockNs_ = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count()
+                        - std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    //encode on the way out, so that recording only stores pointers
+    std::vector<MicrostateFileRecord> out(nRecords);
+    for (uint64_t i=0;i<nRecords;i++) {
+      MicrostateRecord const& r = rec.records_[(count-nRecords+i) % microstateRecordSize_];
+      out[i].timeNs_ = r.time_;
+      out[i].microstate_ = encModule_.encode(r.microstate_);
+      out[i].ministate_ = encPath_[sid].encode(r.ministate_);
+      out[i].kind_ = r.kind_;
+      out[i].reserved_ = 0;
+    }
+
+    std::ostringstream fileName;
+    fileName << "microstaterec_ls" << std::setfill('0') << std::setw(4) << ls
+             << "_pid" << std::setfill('0') << std::setw(5) << getpid()
+             << "_tid" << sid << ".bin";
+    std::string path = (workingDirectory_/fileName.str()).string();
+    FILE * fd = fopen(path.c_str(),"w");
+    if (!fd) {
+      edm::LogWarning("FastMonitoringService") << "Unable to open microstate record file -: " << path;
+      return;
+    }
+    fwrite(&header,sizeof(header),1,fd);
+    if (nRecords)
+      fwrite(&out[0],sizeof(MicrostateFileRecord),nRecords,fd);
+    fclose(fd);
+  }
+
   void FastMonitoringService::doSnapshot(const unsigned int ls, const bool isGlobalEOL) {
     // update macrostate
     fmt_.m_data.fastMacrostateJ_ = macrostate_;
@@ -12,10 +12,14 @@
 #include <zlib.h>
 #include <cstdio>
 #include <chrono>
+#include <bitset>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 
 #include "DataFormats/FEDRawData/interface/FEDNumbering.h"
 #include "DataFormats/FEDRawData/interface/FEDHeader.h"
@@ -757,6 +761,8 @@ edm::Timestamp FedRawDataInputSource::fillFEDRawDataCollection(FEDRawDataCollect
   unsigned char* event = (unsigned char*)event_->payload();
   GTPEventID_=0;
   tcds_pointer_ = nullptr;
+  fedFragments_.clear();
+  std::bitset<FEDNumbering::MAXFEDID+1> seenFeds;
   while (eventSize > 0) {
     assert(eventSize>=FEDTrailer::length);
     eventSize -= FEDTrailer::length;
@@ -789,12 +795,33 @@ edm::Timestamp FedRawDataInputSource::fillFEDRawDataCollection(FEDRawDataCollect
         GTPEventID_ = evf::evtn::gtpe_get(event + eventSize);
       }
     }
-    FEDRawData& fedData = rawData.FEDData(fedId);
-    fedData.resize(fedSize);
-    memcpy(fedData.data(), event + eventSize, fedSize);
+    FedFragment frag = {&rawData.FEDData(fedId), event + eventSize, fedSize};
+    if (seenFeds.test(fedId)) {
+      //a repeated FED ID replaces the fragment seen before, as it used to when copying right away
+      for (auto& f : fedFragments_)
+        if (f.fedData == frag.fedData) f = frag;
+    }
+    else {
+      seenFeds.set(fedId);
+      fedFragments_.push_back(frag);
+    }
   }
   assert(eventSize == 0);
 
+  //copy the fragments once all of them are located; large events are copied concurrently
+  if (event_->eventSize() >= parallelCopyThreshold_) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, fedFragments_.size()),
+                      [this](tbb::blocked_range<size_t> const& r) {
+                        for (size_t i = r.begin(); i != r.end(); ++i)
+                          fedFragments_[i].fedData->assign(fedFragments_[i].data, fedFragments_[i].size);
+                      });
+  }
+  else {
+    for (auto const& frag : fedFragments_)
+      frag.fedData->assign(frag.data, frag.size);
+  }
+  fedFragments_.clear();
+
   return tstamp;
 }
 
@@ -60,6 +60,7 @@ class PulseChiSqSNNLS {
     unsigned int _nP;
     
     SamplePulseMatrix invcovp;
+    SampleVector invcovsamp;
     PulseMatrix aTamat;
     PulseVector aTbvec;
     PulseVector updatework;
@@ -135,6 +135,8 @@ bool PulseChiSqSNNLS::DoFit(const SampleVector &samples, const SampleMatrix &sam
   }
   
   aTamat.resize(_npulsetot,_npulsetot);
+  //NNLSUnconstrainParameter also swaps the columns of invcovp, before NNLS has filled it
+  invcovp.resize(Eigen::NoChange,_npulsetot);
 
   //initialize pulse template matrix
   for (int ipulse=0; ipulse<npulse; ++ipulse) {
@@ -307,7 +309,9 @@ double PulseChiSqSNNLS::ComputeChiSq() {
 //   SampleVector resvec = _pulsemat*_ampvec - _sampvec;
 //   return resvec.transpose()*_covdecomp.solve(resvec);
   
-  return _covdecomp.matrixL().solve(_pulsemat*_ampvec - _sampvec).squaredNorm();
+  //L^-1*pulsemat and L^-1*sampvec are kept from the last minimization step
+  //for the current covariance, so no triangular solve is needed here
+  return (invcovp*_ampvec - invcovsamp).squaredNorm();
   
 }
 
@@ -316,7 +320,7 @@ double PulseChiSqSNNLS::ComputeApproxUncertainty(unsigned int ipulse) {
   //(using 1/second derivative since full Hessian is not meaningful in
   //presence of positive amplitude boundaries.)
       
-  return 1./_covdecomp.matrixL().solve(_pulsemat.col(ipulse)).norm();
+  return 1./invcovp.col(ipulse).norm();
   
 }
 
@@ -328,8 +332,9 @@ bool PulseChiSqSNNLS::NNLS() {
   constexpr unsigned int nsamples = SampleVector::RowsAtCompileTime;
 
   invcovp = _covdecomp.matrixL().solve(_pulsemat);
+  invcovsamp = _covdecomp.matrixL().solve(_sampvec);
   aTamat.noalias() = invcovp.transpose().lazyProduct(invcovp);
-  aTbvec.noalias() = invcovp.transpose().lazyProduct(_covdecomp.matrixL().solve(_sampvec));
+  aTbvec.noalias() = invcovp.transpose().lazyProduct(invcovsamp);
   
   int iter = 0;
   Index idxwmax = 0;
@@ -426,6 +431,7 @@ void PulseChiSqSNNLS::NNLSUnconstrainParameter(Index idxp) {
   aTamat.col(_nP).swap(aTamat.col(idxp));
   aTamat.row(_nP).swap(aTamat.row(idxp));
   _pulsemat.col(_nP).swap(_pulsemat.col(idxp));
+  invcovp.col(_nP).swap(invcovp.col(idxp));
   std::swap(aTbvec.coeffRef(_nP),aTbvec.coeffRef(idxp));
   std::swap(_ampvec.coeffRef(_nP),_ampvec.coeffRef(idxp));
   std::swap(_bxs.coeffRef(_nP),_bxs.coeffRef(idxp));
@@ -436,6 +442,7 @@ void PulseChiSqSNNLS::NNLSConstrainParameter(Index minratioidx) {
   aTamat.col(_nP-1).swap(aTamat.col(minratioidx));
   aTamat.row(_nP-1).swap(aTamat.row(minratioidx));
   _pulsemat.col(_nP-1).swap(_pulsemat.col(minratioidx));
+  invcovp.col(_nP-1).swap(invcovp.col(minratioidx));
   std::swap(aTbvec.coeffRef(_nP-1),aTbvec.coeffRef(minratioidx));
   std::swap(_ampvec.coeffRef(_nP-1),_ampvec.coeffRef(minratioidx));
   std::swap(_bxs.coeffRef(_nP-1),_bxs.coeffRef(minratioidx));
@@ -450,11 +457,12 @@ bool PulseChiSqSNNLS::OnePulseMinimize() {
 //   const unsigned int npulse = 1;
 
   invcovp = _covdecomp.matrixL().solve(_pulsemat);
+  invcovsamp = _covdecomp.matrixL().solve(_sampvec);
 //   aTamat = invcovp.transpose()*invcovp;
 //   aTbvec = invcovp.transpose()*_covdecomp.matrixL().solve(_sampvec);
 
   SingleMatrix aTamatval = invcovp.transpose()*invcovp;
-  SingleVector aTbvecval = invcovp.transpose()*_covdecomp.matrixL().solve(_sampvec);
+  SingleVector aTbvecval = invcovp.transpose()*invcovsamp;
   _ampvec.coeffRef(0) = std::max(0.,aTbvecval.coeff(0)/aTamatval.coeff(0));
   
   return true;
@@ -0,0 +1,82 @@
+/* Unit test for PulseChiSqSNNLS
+   Checks the multi-pulse fit of a synthetic pulse against the direct
+   evaluation of the chi2 with the final covariance.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+
+#include <algorithm>
+#include <cmath>
+
+class testPulseChiSqSNNLS: public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(testPulseChiSqSNNLS);
+  CPPUNIT_TEST(testFit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown() {}
+
+  void testFit();
+
+  FullSampleVector fullpulse_;
+  FullSampleMatrix fullpulsecov_;
+  SampleMatrix noisecov_;
+  BXVector bxs_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testPulseChiSqSNNLS);
+
+void testPulseChiSqSNNLS::setUp() {
+  // alpha-beta like shape peaking at sample 9 of the full pulse
+  for (int i=0; i<FullSampleVectorSize; ++i) {
+    double t = (i-7)/2.;
+    fullpulse_[i] = t>0. ? std::pow(t,2)*std::exp(-2.*(t-1.)) : 0.;
+  }
+  fullpulse_ /= fullpulse_.maxCoeff();
+  fullpulsecov_ = 1e-5*FullSampleMatrix::Identity();
+
+  for (int i=0; i<SampleVectorSize; ++i)
+    for (int j=0; j<SampleVectorSize; ++j)
+      noisecov_(i,j) = std::exp(-std::abs(i-j)/2.);
+
+  bxs_.resize(SampleVectorSize);
+  for (int i=0; i<SampleVectorSize; ++i) bxs_[i] = i-5;
+}
+
+void testPulseChiSqSNNLS::testFit() {
+  // in-time pulse of amplitude 40 plus an early pileup pulse of amplitude 10
+  SampleVector samples = SampleVector::Zero();
+  const double amps[2] = {40., 10.};
+  const int bxs[2] = {0, -2};
+  for (unsigned int ip=0; ip<2; ++ip)
+    samples += amps[ip]*fullpulse_.segment<SampleVectorSize>(7-3-bxs[ip]);
+
+  PulseChiSqSNNLS fit;
+  CPPUNIT_ASSERT(fit.DoFit(samples,noisecov_,bxs_,fullpulse_,fullpulsecov_));
+
+  for (unsigned int ip=0; ip<fit.BXs().rows(); ++ip) {
+    int bx = fit.BXs().coeff(ip);
+    double expected = bx==0 ? amps[0] : (bx==-2 ? amps[1] : 0.);
+    CPPUNIT_ASSERT(std::abs(fit.X().coeff(ip)-expected) < 1e-3);
+    CPPUNIT_ASSERT(bx!=0 || fit.Errors().coeff(ip) > 0.);
+  }
+
+  // the chi2 must be the one of the residuals with the covariance of the last
+  // iteration (the error calculation refits, so it is disabled here)
+  samples[3] += 1.;
+  PulseChiSqSNNLS fitNoErrors;
+  fitNoErrors.disableErrorCalculation();
+  CPPUNIT_ASSERT(fitNoErrors.DoFit(samples,noisecov_,bxs_,fullpulse_,fullpulsecov_));
+  SampleVector res = samples;
+  for (unsigned int ip=0; ip<fitNoErrors.BXs().rows(); ++ip) {
+    int bx = fitNoErrors.BXs().coeff(ip);
+    res -= fitNoErrors.X().coeff(ip)*fullpulse_.segment<SampleVectorSize>(7-3-bx);
+  }
+  double chisq = res.transpose()*fitNoErrors.invcov().ldlt().solve(res);
+  CPPUNIT_ASSERT(fitNoErrors.ChiSq() > 0.);
+  CPPUNIT_ASSERT(std::abs(fitNoErrors.ChiSq()-chisq) < 1e-6*std::max(1.,chisq));
+}
@@ -23,6 +23,7 @@
 #include <numeric>
 
 #include "KDTreeLinkerAlgoT.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
 
 
 template <typename T>
@@ -250,7 +251,6 @@ struct Hexel {
 
 };
 
-typedef KDTreeLinkerAlgo<Hexel,2> KDTree;
 typedef KDTreeNodeInfoT<Hexel,2> KDNode;
 
 
@@ -282,9 +282,9 @@ inline double distance2(const Hexel &pt1, const Hexel &pt2) const{   //distance
 inline double distance(const Hexel &pt1, const Hexel &pt2) const{   //2-d distance on the layer (x-y)
         return std::sqrt(distance2(pt1,pt2));
 }
-double calculateLocalDensity(std::vector<KDNode> &, KDTree &, const unsigned int) const;   //return max density
-double calculateDistanceToHigher(std::vector<KDNode> &) const;
-int findAndAssignClusters(std::vector<KDNode> &, KDTree &, double, KDTreeBox &, const unsigned int, std::vector<std::vector<KDNode> >&) const;
+double calculateLocalDensity(std::vector<KDNode> &, const HGCalLayerTiles &, const unsigned int) const;   //return max density
+double calculateDistanceToHigher(std::vector<KDNode> &, const HGCalLayerTiles &) const;
+int findAndAssignClusters(std::vector<KDNode> &, const HGCalLayerTiles &, double, const unsigned int, std::vector<std::vector<KDNode> >&) const;
 math::XYZPoint calculatePosition(std::vector<KDNode> &) const;
 
 // attempt to find subclusters within a given set of hexels
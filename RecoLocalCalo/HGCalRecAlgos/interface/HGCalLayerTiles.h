@@ -0,0 +1,90 @@
+#ifndef RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+#define RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+
+// C/C++ headers
+#include <algorithm>
+#include <vector>
+
+// Fixed grid of square tiles covering the hits of one layer.
+// The hits are sorted by tile, row by row, and their positions and weights are
+// copied in that order: the hits of consecutive tiles of a row are contiguous,
+// so a search window is a few contiguous ranges, one per row.
+class HGCalLayerTiles
+{
+
+public:
+
+// the tiles are enlarged when needed to keep at most this many per axis
+static constexpr int maxTilesPerAxis = 128;
+
+template <typename Node>
+void fill(const std::vector<Node> &nodes, float xmin, float xmax, float ymin, float ymax, float tileSize)
+{
+        tileSize_ = std::max(tileSize, std::max(xmax - xmin, ymax - ymin) / maxTilesPerAxis);
+        if (!(tileSize_ > 0.f))
+                tileSize_ = 1.f;
+        xmin_ = xmin;
+        ymin_ = ymin;
+        nColumns_ = std::min(maxTilesPerAxis, int((xmax - xmin) / tileSize_) + 1);
+        nRows_ = std::min(maxTilesPerAxis, int((ymax - ymin) / tileSize_) + 1);
+
+        // counting sort of the hits by tile
+        const unsigned int n = nodes.size();
+        std::vector<unsigned int> tileOfHit(n);
+        start_.assign(nColumns_ * nRows_ + 1, 0);
+        for (unsigned int i = 0; i < n; ++i) {
+                tileOfHit[i] = tile(column(nodes[i].data.x), row(nodes[i].data.y));
+                ++start_[tileOfHit[i] + 1];
+        }
+        for (unsigned int t = 0; t < start_.size() - 1; ++t)
+                start_[t + 1] += start_[t];
+
+        index_.resize(n);
+        x_.resize(n);
+        y_.resize(n);
+        weight_.resize(n);
+        std::vector<unsigned int> next(start_.begin(), start_.end() - 1);
+        for (unsigned int i = 0; i < n; ++i) {
+                const unsigned int k = next[tileOfHit[i]]++;
+                index_[k] = i;
+                x_[k] = nodes[i].data.x;
+                y_[k] = nodes[i].data.y;
+                weight_[k] = nodes[i].data.weight;
+        }
+}
+
+int nColumns() const { return nColumns_; }
+int nRows() const { return nRows_; }
+float tileSize() const { return tileSize_; }
+
+// tile coordinates of a position, clamped to the grid
+int column(double x) const { return std::min(std::max(int((x - xmin_) / tileSize_), 0), nColumns_ - 1); }
+int row(double y) const { return std::min(std::max(int((y - ymin_) / tileSize_), 0), nRows_ - 1); }
+unsigned int tile(int column, int row) const { return row * nColumns_ + column; }
+
+// hits [begin, end) of columns firstColumn..lastColumn of a row
+unsigned int begin(int firstColumn, int row) const { return start_[tile(firstColumn, row)]; }
+unsigned int end(int lastColumn, int row) const { return start_[tile(lastColumn, row) + 1]; }
+
+// index of the k-th hit in the input nodes, and its copied position and weight
+unsigned int index(unsigned int k) const { return index_[k]; }
+double x(unsigned int k) const { return x_[k]; }
+double y(unsigned int k) const { return y_[k]; }
+double weight(unsigned int k) const { return weight_[k]; }
+
+private:
+
+float xmin_ = 0.f;
+float ymin_ = 0.f;
+float tileSize_ = 1.f;
+int nColumns_ = 0;
+int nRows_ = 0;
+
+std::vector<unsigned int> start_;
+std::vector<unsigned int> index_;
+std::vector<double> x_;
+std::vector<double> y_;
+std::vector<double> weight_;
+};
+
+#endif
@@ -63,7 +63,7 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection &hits) {
         position.x(), position.y());
 
     // for each layer, store the minimum and maximum x and y coordinates for the
-    // KDTreeBox boundaries
+    // tile boundaries
     if (firstHit[layer]) {
       minpos[layer][0] = position.x();
       minpos[layer][1] = position.y();
@@ -88,23 +88,32 @@ void HGCalImagingAlgo::makeClusters() {
   // assign all hits in each layer to a cluster core or halo
   tbb::this_task_arena::isolate([&] {
     tbb::parallel_for(size_t(0), size_t(2 * maxlayer + 2), [&](size_t i) {
-      KDTreeBox bounds(minpos[i][0], maxpos[i][0], minpos[i][1], maxpos[i][1]);
-      KDTree hit_kdtree;
-      hit_kdtree.build(points[i], bounds);
-
       unsigned int actualLayer =
           i > maxlayer
               ? (i - (maxlayer + 1))
-              : i; // maps back from index used for KD trees to actual layer
+              : i; // maps back from index used for tiles to actual layer
+
+      // tiles of the size of the critical distance, so that the density
+      // search only looks at the neighbouring tiles
+      float delta_c;
+      if (actualLayer <= lastLayerEE)
+        delta_c = vecDeltas[0];
+      else if (actualLayer <= lastLayerFH)
+        delta_c = vecDeltas[1];
+      else
+        delta_c = vecDeltas[2];
+      HGCalLayerTiles tiles;
+      tiles.fill(points[i], minpos[i][0], maxpos[i][0], minpos[i][1],
+                 maxpos[i][1], delta_c);
 
       double maxdensity = calculateLocalDensity(
-          points[i], hit_kdtree, actualLayer); // also stores rho (energy
-                                               // density) for each point (node)
+          points[i], tiles, actualLayer); // also stores rho (energy
+                                          // density) for each point (node)
       // calculate distance to nearest point with higher density storing
       // distance (delta) and point's index
-      calculateDistanceToHigher(points[i]);
-      findAndAssignClusters(points[i], hit_kdtree, maxdensity, bounds,
-                            actualLayer, layerClustersPerLayer[i]);
+      calculateDistanceToHigher(points[i], tiles);
+      findAndAssignClusters(points[i], tiles, maxdensity, actualLayer,
+                            layerClustersPerLayer[i]);
     });
   });
 }
@@ -231,7 +240,7 @@ HGCalImagingAlgo::calculatePosition(std::vector<KDNode> &v) const {
 }
 
 double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd,
-                                               KDTree &lp,
+                                               const HGCalLayerTiles &lt,
                                                const unsigned int layer) const {
 
   double maxdensity = 0.;
@@ -246,24 +255,31 @@ double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd,
 
   // for each node calculate local density rho and store it
   for (unsigned int i = 0; i < nd.size(); ++i) {
-    // speec up search by looking within +/- delta_c window only
-    KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                         nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-    std::vector<KDNode> found;
-    lp.search(search_box, found);
-    const unsigned int found_size = found.size();
-    for (unsigned int j = 0; j < found_size; j++) {
-      if (distance(nd[i].data, found[j].data) < delta_c) {
-        nd[i].data.rho += found[j].data.weight;
-        maxdensity = std::max(maxdensity, nd[i].data.rho);
+    // speed up search by looking within +/- delta_c window only: one
+    // contiguous range of hits per row of tiles
+    const double xi = nd[i].data.x;
+    const double yi = nd[i].data.y;
+    const int firstColumn = lt.column(xi - delta_c);
+    const int lastColumn = lt.column(xi + delta_c);
+    double rho = 0.;
+    for (int row = lt.row(yi - delta_c); row <= lt.row(yi + delta_c); ++row) {
+      const unsigned int end = lt.end(lastColumn, row);
+      for (unsigned int k = lt.begin(firstColumn, row); k < end; ++k) {
+        const double dx = xi - lt.x(k);
+        const double dy = yi - lt.y(k);
+        if (std::sqrt(dx * dx + dy * dy) < delta_c)
+          rho += lt.weight(k);
       }
-    } // end loop found
-  }   // end loop nodes
+    }
+    nd[i].data.rho += rho;
+    maxdensity = std::max(maxdensity, nd[i].data.rho);
+  } // end loop nodes
   return maxdensity;
 }
 
 double
-HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
+HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd,
+                                            const HGCalLayerTiles &lt) const {
 
   // sort vector of Hexels by decreasing local density
   std::vector<size_t> rs = sorted_indices(nd);
@@ -291,21 +307,74 @@ HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
   const double max_dist2 = dist2;
   const unsigned int nd_size = nd.size();
 
+  // position of each hit in the density ordering, and the best one of each
+  // tile, to skip the tiles without any hit of higher density
+  std::vector<unsigned int> rank(nd_size);
+  for (unsigned int oi = 0; oi < nd_size; ++oi)
+    rank[rs[oi]] = oi;
+  std::vector<unsigned int> tileRank(lt.nColumns() * lt.nRows(), nd_size);
+  for (int row = 0; row < lt.nRows(); ++row) {
+    for (int column = 0; column < lt.nColumns(); ++column) {
+      unsigned int &best = tileRank[lt.tile(column, row)];
+      const unsigned int end = lt.end(column, row);
+      for (unsigned int k = lt.begin(column, row); k < end; ++k)
+        best = std::min(best, rank[lt.index(k)]);
+    }
+  }
+  const float tileSize = lt.tileSize();
+  const int maxRing = std::max(lt.nColumns(), lt.nRows());
+
   for (unsigned int oi = 1; oi < nd_size;
        ++oi) { // start from second-highest density
     dist2 = max_dist2;
     unsigned int i = rs[oi];
-    // we only need to check up to oi since hits
+    const double xi = nd[i].data.x;
+    const double yi = nd[i].data.y;
+    const int column0 = lt.column(xi);
+    const int row0 = lt.row(yi);
+    // we only need to check the hits before oi since hits
     // are ordered by decreasing density
     // and all points coming BEFORE oi are guaranteed to have higher rho
-    // and the ones AFTER to have lower rho
-    for (unsigned int oj = 0; oj < oi; ++oj) {
-      unsigned int j = rs[oj];
-      double tmp = distance2(nd[i].data, nd[j].data);
-      if (tmp <= dist2) { // this "<=" instead of "<" addresses the (rare) case
-                          // when there are only two hits
-        dist2 = tmp;
-        nearestHigher = j;
+    // and the ones AFTER to have lower rho.
+    // The tiles are searched in rings of increasing size around the hit,
+    // until the ring is farther than the closest higher hit found; a
+    // margin of one ring covers the rounding of the tile boundaries.
+    bool found = false;
+    unsigned int foundRank = 0;
+    for (int ring = 0; ring <= maxRing; ++ring) {
+      if (ring > 1) {
+        const double ringDistance = (ring - 2) * tileSize;
+        if (ringDistance * ringDistance > dist2)
+          break;
+      }
+      for (int row = std::max(row0 - ring, 0);
+           row <= std::min(row0 + ring, lt.nRows() - 1); ++row) {
+        // inner rows of the ring only have its first and last column
+        const bool edgeRow = (row == row0 - ring || row == row0 + ring);
+        const int step = edgeRow ? 1 : std::max(2 * ring, 1);
+        for (int column = column0 - ring; column <= column0 + ring;
+             column += step) {
+          if (column < 0 || column >= lt.nColumns() ||
+              tileRank[lt.tile(column, row)] >= oi)
+            continue;
+          const unsigned int end = lt.end(column, row);
+          for (unsigned int k = lt.begin(column, row); k < end; ++k) {
+            const unsigned int j = lt.index(k);
+            if (rank[j] >= oi)
+              continue;
+            double tmp = distance2(nd[i].data, nd[j].data);
+            // this "<=" instead of "<" addresses the (rare) case when there
+            // are only two hits; among equally close hits the last one in
+            // the density ordering is kept
+            if (tmp < dist2 ||
+                (tmp == dist2 && (!found || rank[j] > foundRank))) {
+              dist2 = tmp;
+              nearestHigher = j;
+              found = true;
+              foundRank = rank[j];
+            }
+          }
+        }
       }
     }
     nd[i].data.delta = std::sqrt(dist2);
@@ -315,7 +384,7 @@ HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
   return maxdensity;
 }
 int HGCalImagingAlgo::findAndAssignClusters(
-    std::vector<KDNode> &nd, KDTree &lp, double maxdensity, KDTreeBox &bounds,
+    std::vector<KDNode> &nd, const HGCalLayerTiles &lt, double maxdensity,
     const unsigned int layer,
     std::vector<std::vector<KDNode>> &clustersOnLayer) const {
 
@@ -389,39 +458,37 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // assign points closer than dc to other clusters to border region
   // and find critical border density
   std::vector<double> rho_b(nClustersOnLayer, 0.);
-  lp.clear();
-  lp.build(nd, bounds);
   // now loop on all hits again :( and check: if there are hits from another
   // cluster within d_c -> flag as border hit
   for (unsigned int i = 0; i < nd_size; ++i) {
     int ci = nd[i].data.clusterIndex;
     bool flag_isolated = true;
     if (ci != -1) {
-      KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                           nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-      std::vector<KDNode> found;
-      lp.search(search_box, found);
-
-      const unsigned int found_size = found.size();
-      for (unsigned int j = 0; j < found_size;
-           j++) { // start from 0 here instead of 1
-        // check if the hit is not within d_c of another cluster
-        if (found[j].data.clusterIndex != -1) {
-          float dist = distance(found[j].data, nd[i].data);
-          if (dist < delta_c && found[j].data.clusterIndex != ci) {
-            // in which case we assign it to the border
-            nd[i].data.isBorder = true;
-            break;
-          }
-          // because we are using two different containers, we have to make sure
-          // that we don't unflag the
-          // hit when it finds *itself* closer than delta_c
-          if (dist < delta_c && dist != 0. &&
-              found[j].data.clusterIndex == ci) {
-            // in this case it is not an isolated hit
-            // the dist!=0 is because the hit being looked at is also inside the
-            // search box and at dist==0
-            flag_isolated = false;
+      const int firstColumn = lt.column(nd[i].data.x - delta_c);
+      const int lastColumn = lt.column(nd[i].data.x + delta_c);
+      const int lastRow = lt.row(nd[i].data.y + delta_c);
+      for (int row = lt.row(nd[i].data.y - delta_c);
+           row <= lastRow && !nd[i].data.isBorder; ++row) {
+        const unsigned int end = lt.end(lastColumn, row);
+        for (unsigned int k = lt.begin(firstColumn, row); k < end;
+             k++) { // the hit itself is in the window too
+          const Hexel &found = nd[lt.index(k)].data;
+          // check if the hit is not within d_c of another cluster
+          if (found.clusterIndex != -1) {
+            float dist = distance(found, nd[i].data);
+            if (dist < delta_c && found.clusterIndex != ci) {
+              // in which case we assign it to the border
+              nd[i].data.isBorder = true;
+              break;
+            }
+            // make sure that we don't unflag the hit when it finds *itself*
+            // closer than delta_c
+            if (dist < delta_c && dist != 0. && found.clusterIndex == ci) {
+              // in this case it is not an isolated hit
+              // the dist!=0 is because the hit being looked at is also inside
+              // the search window and at dist==0
+              flag_isolated = false;
+            }
           }
         }
       }
@@ -14,6 +14,10 @@
 
 #include <Math/Functor.h>
 
+#include <array>
+#include <memory>
+#include <unordered_map>
+
 struct MahiNnlsWorkspace {
 
   unsigned int nPulseTot;
@@ -81,6 +85,35 @@ struct MahiNnlsWorkspace {
 
 };
 
+//pulse shape template, derivative and covariance for one arrival time
+struct MahiPulseTemplate {
+
+  float t0;
+  double dt;
+  unsigned int tsOffset;
+  unsigned int tsSize;
+
+  FullSampleVector pulseShape;
+  FullSampleVector pulseDeriv;
+  FullSampleMatrix pulseCov;
+
+};
+
+//pulse shape functor of one HcalPulseShapes::Shape and the
+//templates most recently computed with it
+struct MahiPulseShapeCache {
+
+  static constexpr unsigned int maxTemplates = 8;
+
+  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psf;
+  std::unique_ptr<ROOT::Math::Functor> functor;
+
+  std::array<MahiPulseTemplate, maxTemplates> templates;
+  unsigned int nTemplates = 0;
+  unsigned int nextTemplate = 0;
+
+};
+
 struct MahiDebugInfo {
 
   int   nSamples;
@@ -204,8 +237,8 @@ class MahiFit
 
   //for pulse shapes
   int cntsetPulseShape_;
-  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
-  std::unique_ptr<ROOT::Math::Functor> pfunctor_;
+  std::unordered_map<const HcalPulseShapes::Shape*, std::unique_ptr<MahiPulseShapeCache> > pulseShapeCache_;
+  MahiPulseShapeCache* currentPulseShapeCache_=nullptr;
 
 }; 
 #endif
@@ -164,11 +164,11 @@ void MahiFit::doFit(std::array<float,3> &correctedOutput, int nbx) const {
   for (unsigned int iBX=0; iBX<nnlsWork_.nPulseTot; ++iBX) {
     offset=nnlsWork_.bxs.coeff(iBX);
 
-    nnlsWork_.pulseShapeArray[iBX] = FullSampleVector::Zero(MaxFSVSize);
-    nnlsWork_.pulseDerivArray[iBX] = FullSampleVector::Zero(MaxFSVSize);
-    nnlsWork_.pulseCovArray[iBX]   = FullSampleMatrix::Constant(0);
-
     if (offset==pedestalBX_) {
+      nnlsWork_.pulseShapeArray[iBX] = FullSampleVector::Zero(MaxFSVSize);
+      nnlsWork_.pulseDerivArray[iBX] = FullSampleVector::Zero(MaxFSVSize);
+      nnlsWork_.pulseCovArray[iBX]   = FullSampleMatrix::Constant(0);
+
       nnlsWork_.ampVec.coeffRef(iBX) = 0;
     }
     else {
@@ -261,6 +261,23 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
     else t0+=hcalTimeSlewDelay_->delay(itQ,slewFlavor_);
   }
 
+  //the template only depends on the arrival time and the sample layout, so
+  //the unslewed and 1 GeV ones are reused across bunch crossings and channels
+  MahiPulseShapeCache& psCache = *currentPulseShapeCache_;
+  for (unsigned int i=0; i<psCache.nTemplates; ++i) {
+    const MahiPulseTemplate& pt = psCache.templates[i];
+    if (pt.t0==t0 && pt.dt==nnlsWork_.dt && pt.tsOffset==nnlsWork_.tsOffset && pt.tsSize==nnlsWork_.tsSize) {
+      pulseShape = pt.pulseShape;
+      pulseDeriv = pt.pulseDeriv;
+      pulseCov = pt.pulseCov;
+      return;
+    }
+  }
+
+  pulseShape = FullSampleVector::Zero(MaxFSVSize);
+  pulseDeriv = FullSampleVector::Zero(MaxFSVSize);
+  pulseCov   = FullSampleMatrix::Constant(0);
+
   nnlsWork_.pulseN.fill(0);
   nnlsWork_.pulseM.fill(0);
   nnlsWork_.pulseP.fill(0);
@@ -269,14 +286,14 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
   const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
   const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
 
-  (*pfunctor_)(&xx[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseN);
+  (*psCache.functor)(&xx[0]);
+  psCache.psf->getPulseShape(nnlsWork_.pulseN);
 
-  (*pfunctor_)(&xxm[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseM);
+  (*psCache.functor)(&xxm[0]);
+  psCache.psf->getPulseShape(nnlsWork_.pulseM);
   
-  (*pfunctor_)(&xxp[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseP);
+  (*psCache.functor)(&xxp[0]);
+  psCache.psf->getPulseShape(nnlsWork_.pulseP);
 
   //in the 2018+ case where the sample of interest (SOI) is in TS3, add an extra offset to align 
   //with previous SOI=TS4 case assumed by psfPtr_->getPulseShape()
@@ -302,6 +319,18 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
       
     }
   }
+
+  //replace the oldest template
+  MahiPulseTemplate& pt = psCache.templates[psCache.nextTemplate];
+  pt.t0 = t0;
+  pt.dt = nnlsWork_.dt;
+  pt.tsOffset = nnlsWork_.tsOffset;
+  pt.tsSize = nnlsWork_.tsSize;
+  pt.pulseShape = pulseShape;
+  pt.pulseDeriv = pulseDeriv;
+  pt.pulseCov = pulseCov;
+  psCache.nextTemplate = (psCache.nextTemplate+1)%MahiPulseShapeCache::maxTemplates;
+  if (psCache.nTemplates<MahiPulseShapeCache::maxTemplates) ++psCache.nTemplates;
   
 }
 
@@ -480,7 +509,15 @@ void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalT
       hcalTimeSlewDelay_ = hcalTimeSlewDelay;
       tsDelay1GeV_= hcalTimeSlewDelay->delay(1.0, slewFlavor_);
 
-      resetPulseShapeTemplate(ps);
+      //switching back to a shape seen before keeps its functor and templates
+      //(they are keyed by the slewed arrival time, not by the time slew)
+      auto it = pulseShapeCache_.find(&ps);
+      if (it==pulseShapeCache_.end()) {
+	resetPulseShapeTemplate(ps);
+      }
+      else {
+	currentPulseShapeCache_ = it->second.get();
+      }
       currentPulseShape_ = &ps;
     }
 }
@@ -488,12 +525,16 @@ void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalT
 void MahiFit::resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps) { 
   ++ cntsetPulseShape_;
 
+  auto& psCache = pulseShapeCache_[&ps];
+  psCache.reset(new MahiPulseShapeCache());
+
   // only the pulse shape itself from PulseShapeFunctor is used for Mahi
   // the uncertainty terms calculated inside PulseShapeFunctor are used for Method 2 only
-  psfPtr_.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
-						   1,0,0,10));
-  pfunctor_ = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psfPtr_.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+  psCache->psf.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
+							1,0,0,10));
+  psCache->functor = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psCache->psf.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
 
+  currentPulseShapeCache_ = psCache.get();
 
 }
 
@@ -6,12 +6,13 @@
 //!
 //! The clusterization is performed on a matrix with size
 //! equal to the size of the pixel detector, each cell containing 
-//! the ADC count of the corresponding pixel.
-//! The matrix is reset after each clusterization.
+//! the ADC count of the corresponding pixel, and on a bitmap of
+//! the pixels still to be clustered.
+//! The bitmap is reset after each clusterization.
 //!
 //! The search starts from seed pixels, i.e. pixels with sufficiently
 //! large amplitudes, found at the time of filling of the matrix
-//! and stored in a SiPixelArrayBuffer.
+//! and stored in a SiPixelBitmapBuffer.
 //! 
 //! Translate the pixel charge to electrons, we are suppose to
 //! do the calibrations ADC->electrons here.
@@ -21,7 +22,7 @@
 
 // Our own includes
 #include "PixelThresholdClusterizer.h"
-#include "SiPixelArrayBuffer.h"
+#include "SiPixelBitmapBuffer.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationOffline.h"
 // Geometry
 #include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
@@ -159,9 +160,9 @@ void PixelThresholdClusterizer::clusterizeDetUnitT( const T & input,
   for (unsigned int i = 0; i < theSeeds.size(); i++) 
     {
       
-      // Gavril : The charge of seeds that were already inlcuded in clusters is set to 1 electron
+      // Gavril : The seeds that were already inlcuded in clusters are no longer active
       // so we don't want to call "make_cluster" for these cases 
-      if ( theBuffer(theSeeds[i]) >= theSeedThreshold ) 
+      if ( theBuffer.active(theSeeds[i]) && theBuffer(theSeeds[i]) >= theSeedThreshold ) 
 	{  // Is this seed still valid?
 	  //  Make a cluster around this seed
 	  SiPixelCluster && cluster = make_cluster( theSeeds[i] , output);
@@ -201,7 +202,7 @@ void PixelThresholdClusterizer::clear_buffer( DigiIterator begin, DigiIterator e
 {
   for(DigiIterator di = begin; di != end; ++di ) 
     {
-      theBuffer.set_adc( di->row(), di->column(), 0 );   // reset pixel adc to 0
+      theBuffer.clear( di->row(), di->column() );   // reset pixel
     }
 }
 
@@ -213,7 +214,7 @@ void PixelThresholdClusterizer::clear_buffer( ClusterIterator begin, ClusterIter
         {
           const SiPixelCluster::Pixel pixel = ci->pixel(i);
 
-          theBuffer.set_adc( pixel.x, pixel.y, 0 );   // reset pixel adc to 0
+          theBuffer.clear( pixel.x, pixel.y );   // reset pixel
         }
     }
 }
@@ -396,7 +397,7 @@ PixelThresholdClusterizer::make_cluster( const SiPixelCluster::PixelPos& pix,
   stack<SiPixelCluster::PixelPos, vector<SiPixelCluster::PixelPos> > dead_pixel_stack;
   
   //The individual modules have been loaded into a buffer.
-  //After each pixel has been considered by the clusterizer, we set the adc count to 1
+  //After each pixel has been considered by the clusterizer, we clear its occupancy bit
   //to mark that we have already considered it.
   //The only difference between dead/noisy pixels and standard ones is that for dead/noisy pixels,
   //We consider the charge of the pixel to always be zero.
@@ -413,7 +414,7 @@ PixelThresholdClusterizer::make_cluster( const SiPixelCluster::PixelPos& pix,
     else {
   */
   seed_adc = theBuffer(pix.row(), pix.col());
-  theBuffer.set_adc( pix, 1);
+  theBuffer.clear( pix);
       //  }
   
   AccretionCluster acluster;
@@ -425,13 +426,15 @@ PixelThresholdClusterizer::make_cluster( const SiPixelCluster::PixelPos& pix,
     {
       //This is the standard algorithm to find and add a pixel
       auto curInd = acluster.top(); acluster.pop();
-      for ( auto c = std::max(0,int(acluster.y[curInd])-1); c < std::min(int(acluster.y[curInd])+2,theBuffer.columns()) ; ++c) {
-	for ( auto r = std::max(0,int(acluster.x[curInd])-1); r < std::min(int(acluster.x[curInd])+2,theBuffer.rows()); ++r)  {
-	  if ( theBuffer(r,c) >= thePixelThreshold) {
-	    SiPixelCluster::PixelPos newpix(r,c);
-	    if (!acluster.add( newpix, theBuffer(r,c))) goto endClus;
-	    theBuffer.set_adc( newpix, 1);
-	  }
+      // the active neighbours of a column come as one word: visit them in the
+      // same column then row order as a scan of the 3x3 neighbourhood
+      int row = acluster.x[curInd];
+      for ( auto c = int(acluster.y[curInd])-1; c < int(acluster.y[curInd])+2; ++c) {
+	for ( auto nb = theBuffer.neighbours(row,c); nb; nb &= nb-1) {
+	  auto r = row - 1 + __builtin_ctz(nb);
+	  SiPixelCluster::PixelPos newpix(r,c);
+	  if (!acluster.add( newpix, theBuffer(r,c))) goto endClus;
+	  theBuffer.clear( newpix);
 	     
 
 	      /* //Commenting out the addition of dead pixels to the cluster until further testing -- dfehling 06/09
@@ -481,7 +484,7 @@ PixelThresholdClusterizer::make_cluster( const SiPixelCluster::PixelPos& pix,
 	{
 	  //consider each found dead pixel
 	  SiPixelCluster::PixelPos deadpix = dead_pixel_stack.top(); dead_pixel_stack.pop();
-	  theBuffer.set_adc(deadpix, 1);
+	  theBuffer.clear(deadpix);
 	 
 	  //Clusterize the split cluster using the dead pixel as a seed
 	  SiPixelCluster second_cluster = make_cluster(deadpix, output);
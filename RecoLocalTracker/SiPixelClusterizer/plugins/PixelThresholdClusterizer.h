@@ -14,8 +14,9 @@
 //! 
 //! The clusterization is performed on a matrix with size
 //! equal to the size of the pixel detector, each cell containing 
-//! the ADC count of the corresponding pixel.
-//! The matrix is reset after each clusterization.
+//! the ADC count of the corresponding pixel, together with an
+//! occupancy bitmap of the pixels still to be clustered.
+//! The bitmap is reset after each clusterization.
 //!
 //! The search starts from seed pixels, i.e. pixels with sufficiently
 //! large amplitudes, found at the time of filling of the matrix
@@ -45,7 +46,7 @@
 #include "PixelClusterizerBase.h"
 
 // The private pixel buffer
-#include "SiPixelArrayBuffer.h"
+#include "SiPixelBitmapBuffer.h"
 
 // Parameter Set:
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
@@ -86,7 +87,7 @@ class dso_hidden PixelThresholdClusterizer final : public PixelClusterizerBase {
                            edmNew::DetSetVector<SiPixelCluster>::FastFiller& output);
 
   //! Data storage
-  SiPixelArrayBuffer               theBuffer;         // internal nrow * ncol matrix
+  SiPixelBitmapBuffer              theBuffer;         // internal nrow * ncol matrix
   bool                             bufferAlreadySet;  // status of the buffer array
   std::vector<SiPixelCluster::PixelPos>  theSeeds;          // cached seed pixels
   std::vector<SiPixelCluster>            theClusters;       // resulting clusters  
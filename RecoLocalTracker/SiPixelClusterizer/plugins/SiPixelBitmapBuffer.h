@@ -0,0 +1,88 @@
+#ifndef RecoLocalTracker_SiPixelClusterizer_SiPixelBitmapBuffer_H
+#define RecoLocalTracker_SiPixelClusterizer_SiPixelBitmapBuffer_H
+
+//----------------------------------------------------------------------------
+//! \class SiPixelBitmapBuffer
+//! \brief Occupancy bitmap and charges of the pixels of a module during clustering.
+//!
+//! One bit per pixel tells whether the pixel is above threshold and not yet
+//! part of a cluster; the charge is only meaningful for pixels whose bit is set,
+//! so only the bits need to be reset between modules.
+//!
+//! The bits of a column are stored in consecutive 64 bit words, with an empty
+//! pixel on each side of every column and an empty column on each side of the
+//! module: the bits of the three neighbours of a pixel in a column are read
+//! with one shift, without bound checks.
+//----------------------------------------------------------------------------
+
+// We use PixelPos which is an inner class of SiPixelCluster:
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+
+#include <vector>
+#include <cstdint>
+
+
+class SiPixelBitmapBuffer
+{
+ public:
+  SiPixelBitmapBuffer() {}
+
+  inline void setSize( int rows, int cols);
+  int rows() const { return nrows;}
+  int columns() const { return ncols;}
+
+  /// the pixel is above threshold and not yet clustered
+  bool active( int row, int col) const { return bits[word(row,col)] & bit(row); }
+  bool active( const SiPixelCluster::PixelPos& pix) const { return active(pix.row(), pix.col()); }
+
+  /// charge of an active pixel
+  int operator()( int row, int col) const { return adcs[index(row,col)];}
+  int operator()( const SiPixelCluster::PixelPos& pix) const { return adcs[index(pix.row(), pix.col())];}
+
+  /// set the charge of a pixel and make it active
+  void set_adc( int row, int col, int adc) { adcs[index(row,col)] = adc; bits[word(row,col)] |= bit(row); }
+  void set_adc( const SiPixelCluster::PixelPos& pix, int adc) { set_adc(pix.row(), pix.col(), adc); }
+  /// add to the charge of a pixel, starting from zero if it is not active
+  void add_adc( int row, int col, int adc) { if (!active(row,col)) adcs[index(row,col)] = 0; set_adc(row, col, (*this)(row,col)+adc); }
+
+  /// the pixel is clustered, or no longer needed
+  void clear( int row, int col) { bits[word(row,col)] &= ~bit(row); }
+  void clear( const SiPixelCluster::PixelPos& pix) { clear(pix.row(), pix.col()); }
+
+  /// active pixels among rows row-1, row, row+1 of column col (bit 0 is row-1);
+  /// col may be one past either edge of the module, and row at either edge
+  inline unsigned int neighbours( int row, int col) const;
+
+ private:
+  int index( int row, int col) const { return col*nrows+row;}
+  // the pixel bits start from bit 1 of the first word of their column
+  int word( int row, int col) const { return (col+1)*wordsPerCol + ((row+1)>>6);}
+  static uint64_t bit( int row) { return uint64_t(1) << ((row+1)&63);}
+
+  std::vector<uint64_t> bits;
+  std::vector<int> adcs;
+  int nrows = 0;
+  int ncols = 0;
+  int wordsPerCol = 0;
+};
+
+
+void SiPixelBitmapBuffer::setSize( int rows, int cols) {
+  nrows = rows;
+  ncols = cols;
+  wordsPerCol = (rows+2+63)/64;
+  bits.assign((cols+2)*wordsPerCol, 0);
+  adcs.assign(rows*cols, 0);
+}
+
+
+unsigned int SiPixelBitmapBuffer::neighbours( int row, int col) const {
+  // bits row, row+1, row+2 of the column are rows row-1, row, row+1
+  auto const * w = &bits[(col+1)*wordsPerCol + (row>>6)];
+  auto shift = row&63;
+  uint64_t v = w[0] >> shift;
+  if (shift > 61) v |= w[1] << (64-shift);  // w[1] is in the column: row+2 < 64*wordsPerCol
+  return v & 7;
+}
+
+#endif
@@ -40,10 +40,65 @@ clusterizeDetUnit_(const digiDetSet& digis, output_t::TSFastFiller& output) cons
   }
 
   State state(det);
+  uint16_t strips[maxBlockSize];
+  uint8_t adcs[maxBlockSize];
   while( scan != end ) {
-    while( scan != end  && !candidateEnded(state, scan->strip() ) ) 
-      addToCandidate( state, *scan++);
-    endCandidate(state, output);
+    unsigned int n = 0;
+    for( ; scan != end && n < maxBlockSize; ++scan, ++n) {
+      strips[n] = scan->strip();
+      adcs[n] = scan->adc();
+    }
+    addBlock(state, strips, adcs, n, output);
+  }
+  endCandidate(state, output);
+}
+
+template<class T>
+inline
+void ThreeThresholdAlgorithm::
+addFed_(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, T & out) const {
+  // a channel holds at most the 256 strips of its apv pair, each once
+  uint16_t strips[maxBlockSize];
+  uint8_t adcs[maxBlockSize];
+  unsigned int n = 0;
+  try {
+    while (unpacker.hasData()) {
+      if (n == maxBlockSize) { addBlock(state, strips, adcs, n, out); n = 0; }
+      strips[n] = unpacker.sampleNumber()+ipair*256;
+      adcs[n] = unpacker.adc();
+      ++n;
+      unpacker++;
+    }
+  } catch (...) {
+    // keep the strips unpacked before the corruption, as strip by strip unpacking does
+    addBlock(state, strips, adcs, n, out);
+    throw;
+  }
+  addBlock(state, strips, adcs, n, out);
+}
+
+// The noise decoding and the channel and seed thresholds do not depend on the
+// candidate: evaluate them over the whole block in plain loops the compiler can
+// vectorize, then build the candidates from the strips above threshold.
+// Skipping the strips below threshold gives the same clusters, as a candidate
+// that would end at such a strip also ends at the next strip that is added.
+template<class T>
+inline
+void ThreeThresholdAlgorithm::
+addBlock(State & state, const uint16_t * strips, const uint8_t * adcs, unsigned int n, T & out) const {
+  auto const & det = state.det();
+  float noise[maxBlockSize];
+  bool aboveChannel[maxBlockSize], aboveSeed[maxBlockSize];
+  for (unsigned int i=0; i<n; ++i)
+    noise[i] = det.noise(strips[i]);
+  for (unsigned int i=0; i<n; ++i) {
+    aboveChannel[i] = adcs[i] >= static_cast<uint8_t>( noise[i] * ChannelThreshold);
+    aboveSeed[i] = adcs[i] >= static_cast<uint8_t>( noise[i] * SeedThreshold);
+  }
+  for (unsigned int i=0; i<n; ++i) {
+    if (!aboveChannel[i] || det.bad(strips[i])) continue;
+    if (candidateEnded(state, strips[i])) endCandidate(state, out);
+    addToCandidate(state, strips[i], adcs[i], noise[i], aboveSeed[i]);
   }
 }
 
@@ -67,12 +122,18 @@ addToCandidate(State & state, uint16_t strip, uint8_t adc) const {
   if(  adc < static_cast<uint8_t>( Noise * ChannelThreshold) || state.det().bad(strip) )
     return;
 
-  if(state.candidateLacksSeed) state.candidateLacksSeed  =  adc < static_cast<uint8_t>( Noise * SeedThreshold);
+  addToCandidate(state, strip, adc, Noise, adc >= static_cast<uint8_t>( Noise * SeedThreshold));
+}
+
+inline 
+void ThreeThresholdAlgorithm::
+addToCandidate(State & state, uint16_t strip, uint8_t adc, float noise, bool seed) const { 
+  if(state.candidateLacksSeed) state.candidateLacksSeed  =  !seed;
   if(state.ADCs.empty()) state.lastStrip = strip - 1; // begin candidate
   while( ++state.lastStrip < strip ) state.ADCs.push_back(0); // pad holes
 
   state.ADCs.push_back( adc );
-  state.noiseSquared += Noise*Noise;
+  state.noiseSquared += noise*noise;
 }
 
 template <class T>
@@ -143,3 +204,13 @@ void ThreeThresholdAlgorithm::
 stripByStripEnd(State & state, std::vector<SiStripCluster>& out) const { 
   endCandidate(state, out);
 }
+
+void ThreeThresholdAlgorithm::
+addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out) const {
+  addFed_(state, unpacker, ipair, out);
+}
+
+void ThreeThresholdAlgorithm::
+addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, output_t::TSFastFiller & out) const {
+  addFed_(state, unpacker, ipair, out);
+}
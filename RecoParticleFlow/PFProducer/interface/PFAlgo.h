@@ -239,16 +239,20 @@ class PFAlgo {
   
  protected:
 
-  /// process one block. can be reimplemented in more sophisticated 
-  /// algorithms
+  /// process one block, adding its candidates to pfCandidates.
+  /// can be reimplemented in more sophisticated algorithms.
+  /// Blocks are processed concurrently unless debug_, usePFElectrons_ or
+  /// usePFPhotons_ is set.
   virtual void processBlock( const reco::PFBlockRef& blockref,
                              std::list<reco::PFBlockRef>& hcalBlockRefs, 
-                             std::list<reco::PFBlockRef>& ecalBlockRefs ); 
+                             std::list<reco::PFBlockRef>& ecalBlockRefs,
+                             reco::PFCandidateCollection& pfCandidates ); 
   
   /// Reconstruct a charged particle from a track
-  /// Returns the index of the newly created candidate in pfCandidates_
+  /// Returns the index of the newly created candidate in pfCandidates
   /// Michalis added a flag here to treat muons inside jets
-  unsigned reconstructTrack( const reco::PFBlockElement& elt,bool allowLoose= false);
+  unsigned reconstructTrack( reco::PFCandidateCollection& pfCandidates,
+                             const reco::PFBlockElement& elt,bool allowLoose= false);
 
   /// Reconstruct a neutral particle from a cluster. 
   /// If chargedEnergy is specified, the neutral 
@@ -256,7 +260,8 @@ class PFAlgo {
   /// larger than the chargedEnergy. In this case, the energy of the 
   /// neutral particle is cluster energy - chargedEnergy
 
-  unsigned reconstructCluster( const reco::PFCluster& cluster,
+  unsigned reconstructCluster( reco::PFCandidateCollection& pfCandidates,
+                               const reco::PFCluster& cluster,
                                double particleEnergy,
 			       bool useDirection = false,
 			       double particleX=0.,
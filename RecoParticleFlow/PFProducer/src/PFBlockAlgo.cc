@@ -11,6 +11,8 @@
 #include <algorithm>
 #include "TMath.h"
 
+#include "tbb/parallel_for.h"
+
 using namespace std;
 using namespace reco;
 
@@ -162,25 +164,52 @@ void PFBlockAlgo::findBlocks() {
   else                blocks_.reset( new reco::PFBlockCollection );
   blocks_->reserve(elements_.size());
 
-  QuickUnion qu(bare_elements_.size());
-  const auto elem_size = bare_elements_.size();
+  // evaluate the links of all the pairs in parallel, one task per first
+  // element, in both orders; the elements are sorted by type, so the pairs
+  // without a linker are skipped a type range at a time
+  const unsigned elem_size = bare_elements_.size();
+  std::vector<std::vector<unsigned> > linkedTo(elem_size), linkedFrom(elem_size);
+  tbb::parallel_for( 0u, elem_size, [&](unsigned i) {
+      auto p1(bare_elements_[i]);
+      for( unsigned j = i+1; j < elem_size; ++j ) {
+        auto p2(bare_elements_[j]);
+        const unsigned index = linkTestSquare_[p1->type()][p2->type()];
+        if( !linkTests_[index] ) {
+          j = ranges_[p2->type()].second;
+          continue;
+        }
+        const auto& linker = linkTests_[index];
+        if( linker->linkPrefilter(p1,p2) && linker->testLink(p1,p2) > -0.5 ) {
+          linkedTo[i].push_back(j);
+        }
+        if( linker->linkPrefilter(p2,p1) && linker->testLink(p2,p1) > -0.5 ) {
+          linkedFrom[i].push_back(j);
+        }
+      }
+    } );
+
+  // linked[i] lists in increasing order the elements j for which the test (i,j) succeeds
+  std::vector<std::vector<unsigned> > linked(elem_size);
   for( unsigned i = 0; i < elem_size; ++i ) {
+    for( unsigned j : linkedFrom[i] ) linked[j].push_back(i);
+    linked[i].insert(linked[i].end(),linkedTo[i].begin(),linkedTo[i].end());
+  }
+
+  // the components are then built by the same sequence of union-find calls as
+  // when the links were tested in this loop, so that the blocks and the order
+  // of their elements do not change
+  QuickUnion qu(elem_size);
+  for( unsigned i = 0; i < elem_size; ++i ) {
+    auto next = linked[i].cbegin();
     for( unsigned j = 0; j < elem_size; ++j ) {
       if( qu.connected(i,j) || j == i ) continue;
       if( !linkTests_[linkTestSquare_[bare_elements_[i]->type()][bare_elements_[j]->type()]] ) {
         j = ranges_[bare_elements_[j]->type()].second;
         continue;
       }
-      auto p1(bare_elements_[i]), p2(bare_elements_[j]);
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();
-      const unsigned index = linkTestSquare_[type1][type2];
-      if( linkTests_[index]->linkPrefilter(p1,p2) ) {
-        const double dist = linkTests_[index]->testLink(p1,p2);
-        // compute linking info if it is possible
-        if( dist > -0.5 ) {
-          qu.unite(i,j);
-        }
+      while( next != linked[i].cend() && *next < j ) ++next;
+      if( next != linked[i].cend() && *next == j ) {
+        qu.unite(i,j);
       }
     }
   }
@@ -117,9 +117,11 @@ public:
   }
   
 
-  void checkAlignmentAndAct(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
+  // call act(innerCell, thisCell) for each of the innerCells aligned with this one
+  template<typename Act>
+  void checkAlignmentAndAct(CAColl const & allCells, CAntuple const & innerCells, const float ptmin, const float region_origin_x,
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut, std::vector<CACell::CAntuplet> * foundTriplets) {
+			    const float phiCut, const float hardPtCut, Act && act) const {
     int ncells = innerCells.size();
     int constexpr VSIZE = 16;
     int ok[VSIZE];
@@ -142,10 +144,7 @@ public:
 	auto & oc =  allCells[koc]; 
 	if (ok[j]&&haveSimilarCurvature(oc,ptmin, region_origin_x, region_origin_y,
 					region_origin_radius, phiCut, hardPtCut)) {
-	  if (foundTriplets) foundTriplets->emplace_back(CACell::CAntuplet{koc,cellId});
-	  else {
-	    oc.tagAsOuterNeighbor(cellId);
-	  }
+	  act(koc, cellId);
 	}
       }
     };
@@ -159,7 +158,7 @@ public:
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
 			    const float phiCut, const float hardPtCut) {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, nullptr);
+			 phiCut, hardPtCut, [&](unsigned int koc, unsigned int cellId) { allCells[koc].tagAsOuterNeighbor(cellId); });
     
   }
   void checkAlignmentAndPushTriplet(CAColl& allCells, CAntuple & innerCells, std::vector<CACell::CAntuplet>& foundTriplets,
@@ -167,7 +166,7 @@ public:
 				    const float region_origin_radius, const float thetaCut, const float phiCut,
 				    const float hardPtCut) {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, &foundTriplets);
+			 phiCut, hardPtCut, [&](unsigned int koc, unsigned int cellId) { foundTriplets.emplace_back(CACell::CAntuplet{koc,cellId}); });
   }
   
   
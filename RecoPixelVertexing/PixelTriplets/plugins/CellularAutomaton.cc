@@ -1,10 +1,25 @@
 #include "CellularAutomaton.h"
 
 #include<queue>
+#include<utility>
+#include<algorithm>
+#include<cassert>
 
+#include "tbb/parallel_for.h"
 
-void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
-		const float thetaCut, const float phiCut, const float hardPtCut)
+namespace {
+  // the cells of a layer pair are connected, and the root cells followed, in chunks of this
+  // size; the chunks run concurrently and their results are merged in order, so the
+  // outcome does not depend on the scheduling
+  constexpr unsigned int chunkSize = 256;
+
+  inline unsigned int nChunks(unsigned int n) { return (n+chunkSize-1)/chunkSize; }
+}
+
+
+template<typename Act>
+void CellularAutomaton::createCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut, Act && act)
 {
         int tsize=0;
         for ( auto hd :  hitDoublets) tsize+=hd->size();
@@ -15,12 +30,8 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 	float region_origin_y = region.origin().y();
 	float region_origin_radius = region.originRBound();
 
-	std::vector<bool> alreadyVisitedLayerPairs;
-	alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
-	for (auto visited : alreadyVisitedLayerPairs)
-	{
-		visited = false;
-	}
+	std::vector<bool> alreadyVisitedLayerPairs(theLayerGraph.theLayerPairs.size(), false);
+	std::vector<std::vector<std::pair<unsigned int, unsigned int>>> links;
 	for (int rootVertex : theLayerGraph.theRootLayers)
 	{
 
@@ -68,17 +79,38 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 				  currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
 														     
 				  cellId++;
-
-				  auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-				  allCells.back().checkAlignmentAndTag(allCells,
-								       neigCells, ptmin, region_origin_x,
-								       region_origin_y, region_origin_radius, thetaCut,
-								       phiCut, hardPtCut
-								       );
-				  
-
 				}
 				assert(cellId==currentLayerPairRef.theFoundCells[1]);
+
+				// the connections to the cells of the inner layer pairs only read the cells:
+				// collect them concurrently per chunk, then act on them in cell order
+				auto firstCell = currentLayerPairRef.theFoundCells[0];
+				auto connect = [&](unsigned int begin, unsigned int end, auto && action) {
+				  for (auto i = begin; i < end; ++i)
+				  {
+				    auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i-firstCell)];
+				    allCells[i].checkAlignmentAndAct(allCells,
+								     neigCells, ptmin, region_origin_x,
+								     region_origin_y, region_origin_radius, thetaCut,
+								     phiCut, hardPtCut, action);
+				  }
+				};
+				auto chunks = nChunks(numberOfDoublets);
+				if (chunks <= 1)
+				{
+				  connect(firstCell, cellId, act);
+				}
+				else
+				{
+				  links.resize(chunks);
+				  tbb::parallel_for(0U, chunks, [&](unsigned int c) {
+				      links[c].clear();
+				      connect(firstCell+c*chunkSize, std::min(firstCell+(c+1)*chunkSize, cellId),
+					      [&](unsigned int koc, unsigned int me) { links[c].emplace_back(koc, me); });
+				    });
+				  for (unsigned int c = 0; c < chunks; ++c)
+				    for (auto const & link : links[c]) act(link.first, link.second);
+				}
 				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
 				{
 					LayerPairsToVisit.push(outerLayerPair);
@@ -99,31 +131,35 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 
 }
 
+void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut)
+{
+	createCells(hitDoublets, region, thetaCut, phiCut, hardPtCut,
+		    [this](unsigned int innerCell, unsigned int cell) { allCells[innerCell].tagAsOuterNeighbor(cell); });
+}
+
 void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 {
   allStatus.resize(allCells.size());
   
+  // every cell belongs to one layer pair: loop over all of them at once, each cell only
+  // writes its own status so the chunks can run concurrently
+  unsigned int numberOfCells = allCells.size();
+  auto forAllCells = [&](auto && f) {
+    tbb::parallel_for(0U, nChunks(numberOfCells), [&](unsigned int c) {
+	auto end = std::min((c+1)*chunkSize, numberOfCells);
+	for (auto i = c*chunkSize; i < end; ++i) f(i);
+      });
+  };
   
   unsigned int numberOfIterations = minHitsPerNtuplet - 2;
   // keeping the last iteration for later
   for (unsigned int iteration = 0; iteration < numberOfIterations - 1;
        ++iteration)
     {
-      for (auto& layerPair : theLayerGraph.theLayerPairs)
-	{
-	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i)
-	    {
-	      allCells[i].evolve(i,allStatus);
-	    }
-	}
+      forAllCells([&](unsigned int i) { allCells[i].evolve(i,allStatus); });
       
-      for (auto& layerPair : theLayerGraph.theLayerPairs)
-	{
-	  for (auto i =layerPair.theFoundCells[0]; i<layerPair.theFoundCells[1]; ++i)
-	    {
-	      allStatus[i].updateState();
-	    }
-	}
+      forAllCells([&](unsigned int i) { allStatus[i].updateState(); });
       
     }
 
@@ -154,112 +190,41 @@ void CellularAutomaton::findNtuplets(
 		std::vector<CACell::CAntuplet>& foundNtuplets,
 		const unsigned int minHitsPerNtuplet)
 {
-	CACell::CAntuple tmpNtuplet;
-	tmpNtuplet.reserve(minHitsPerNtuplet);
-
-	for (auto root_cell : theRootCells)
+	auto findFrom = [&](unsigned int begin, unsigned int end, std::vector<CACell::CAntuplet>& result) {
+	  CACell::CAntuple tmpNtuplet;
+	  tmpNtuplet.reserve(minHitsPerNtuplet);
+	  for (auto i = begin; i < end; ++i)
+	  {
+	    auto root_cell = theRootCells[i];
+	    tmpNtuplet.clear();
+	    tmpNtuplet.push_back(root_cell);
+	    allCells[root_cell].findNtuplets(allCells,result, tmpNtuplet, minHitsPerNtuplet);
+	  }
+	};
+
+	unsigned int numberOfRootCells = theRootCells.size();
+	auto chunks = nChunks(numberOfRootCells);
+	if (chunks <= 1)
 	{
-	  tmpNtuplet.clear();
-	  tmpNtuplet.push_back(root_cell);
-	  allCells[root_cell].findNtuplets(allCells,foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+	  findFrom(0, numberOfRootCells, foundNtuplets);
+	  return;
 	}
 
+	// the search only reads the cells: follow the root cells concurrently per chunk
+	// and append the ntuplets in root cell order
+	std::vector<std::vector<CACell::CAntuplet>> ntuplets(chunks);
+	tbb::parallel_for(0U, chunks, [&](unsigned int c) {
+	    findFrom(c*chunkSize, std::min((c+1)*chunkSize, numberOfRootCells), ntuplets[c]);
+	  });
+	for (auto & chunk : ntuplets)
+	  for (auto & ntuplet : chunk) foundNtuplets.push_back(std::move(ntuplet));
+
 }
 
 
 void CellularAutomaton::findTriplets(const std::vector<const HitDoublets*>& hitDoublets,std::vector<CACell::CAntuplet>& foundTriplets, const TrackingRegion& region,
 		const float thetaCut, const float phiCut, const float hardPtCut)
 {
-        int tsize=0;
-        for ( auto hd :  hitDoublets) tsize+=hd->size();
-        allCells.reserve(tsize);
-
-        unsigned int cellId = 0;
-	float ptmin = region.ptMin();
-	float region_origin_x = region.origin().x();
-	float region_origin_y = region.origin().y();
-	float region_origin_radius = region.originRBound();
-
-	std::vector<bool> alreadyVisitedLayerPairs;
-	alreadyVisitedLayerPairs.resize(theLayerGraph.theLayerPairs.size());
-	for (auto visited : alreadyVisitedLayerPairs)
-	{
-		visited = false;
-	}
-	for (int rootVertex : theLayerGraph.theRootLayers)
-	{
-
-		std::queue<int> LayerPairsToVisit;
-
-		for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs)
-		{
-			LayerPairsToVisit.push(LayerPair);
-
-		}
-
-		unsigned int numberOfLayerPairsToVisitAtThisDepth =
-				LayerPairsToVisit.size();
-
-		while (!LayerPairsToVisit.empty())
-		{
-			auto currentLayerPair = LayerPairsToVisit.front();
-			auto & currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
-			auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
-			auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
-			bool allInnerLayerPairsAlreadyVisited	{ true };
-
-			for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs)
-			{
-				allInnerLayerPairsAlreadyVisited &=
-						alreadyVisitedLayerPairs[innerLayerPair];
-			}
-
-			if (alreadyVisitedLayerPairs[currentLayerPair] == false
-					&& allInnerLayerPairsAlreadyVisited)
-			{
-
-				const HitDoublets* doubletLayerPairId =
-						hitDoublets[currentLayerPair];
-				auto numberOfDoublets = doubletLayerPairId->size();
-				currentLayerPairRef.theFoundCells[0] = cellId;
-				currentLayerPairRef.theFoundCells[1] = cellId+numberOfDoublets;
-				for (unsigned int i = 0; i < numberOfDoublets; ++i)
-				{
-				  allCells.emplace_back(doubletLayerPairId, i,
-							doubletLayerPairId->innerHitId(i),
-							doubletLayerPairId->outerHitId(i));
-				  
-										  
-				  currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
-														     
-				  cellId++;
-
-				  auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
-				  allCells.back().checkAlignmentAndPushTriplet(allCells,
-									       neigCells, foundTriplets, ptmin, region_origin_x,
-									       region_origin_y, region_origin_radius, thetaCut,
-									       phiCut, hardPtCut
-									       );
-				}
-				assert(cellId==currentLayerPairRef.theFoundCells[1]);
-
-
-				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
-				{
-					LayerPairsToVisit.push(outerLayerPair);
-				}
-
-				alreadyVisitedLayerPairs[currentLayerPair] = true;
-			}
-			LayerPairsToVisit.pop();
-			numberOfLayerPairsToVisitAtThisDepth--;
-			if (numberOfLayerPairsToVisitAtThisDepth == 0)
-			{
-				numberOfLayerPairsToVisitAtThisDepth = LayerPairsToVisit.size();
-			}
-
-		}
-
-	}
-
+	createCells(hitDoublets, region, thetaCut, phiCut, hardPtCut,
+		    [&](unsigned int innerCell, unsigned int cell) { foundTriplets.emplace_back(CACell::CAntuplet{innerCell, cell}); });
 }
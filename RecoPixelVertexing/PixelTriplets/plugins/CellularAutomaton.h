@@ -25,6 +25,10 @@ public:
 		    const float thetaCut, const float phiCut, const float hardPtCut);
   
 private:
+  // create the cells of all the layer pairs and call act(innerCell, cell) for each pair of aligned cells
+  template<typename Act>
+  void createCells(const std::vector<const HitDoublets *>&, const TrackingRegion&, const float, const float, const float, Act &&);
+
   CAGraph & theLayerGraph;
 
   std::vector<CACell> allCells;
@@ -71,6 +71,10 @@ namespace cms
     RedundantSeedCleaner*  theSeedCleaner;
 
     unsigned int maxSeedsBeforeCleaning_;
+
+    /// number of seeds built concurrently before their results are merged
+    /// in seed order (0: build the seeds one after the other)
+    unsigned int seedBatchSize_;
     
     edm::EDGetTokenT<edm::View<TrajectorySeed> >  theSeedLabel;
     edm::EDGetTokenT<MeasurementTrackerEvent>     theMTELabel;
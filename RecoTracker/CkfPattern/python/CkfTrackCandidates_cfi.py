@@ -16,6 +16,9 @@ ckfTrackCandidates = cms.EDProducer("CkfTrackCandidateMaker",
 #    SeedLabel = cms.string(''),
     maxNSeeds = cms.uint32(500000),
     maxSeedsBeforeCleaning = cms.uint32(5000),
+# Number of seeds built concurrently before their trajectories are merged
+# in seed order (0: serial); the result does not depend on it
+    seedBatchSize = cms.uint32(0),
 # SeedProducer:SeedLabel descoped to src
     src = cms.InputTag('globalMixedSeeds'),                                  
     SimpleMagneticField = cms.string(''),                                    
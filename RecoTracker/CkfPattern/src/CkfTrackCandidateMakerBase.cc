@@ -25,6 +25,7 @@
 
 
 #include "RecoTracker/CkfPattern/interface/CachingSeedCleanerBySharedInput.h"
+#include "RecoTracker/CkfPattern/interface/CkfTrajectoryBuilder.h"
 
 #include "RecoTracker/MeasurementDet/interface/MeasurementTrackerEvent.h"
 
@@ -41,9 +42,7 @@
 // #define VI_TBB
 
 #include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -74,6 +73,7 @@ namespace cms{
     theNavigationSchool(nullptr),
     theSeedCleaner(nullptr),
     maxSeedsBeforeCleaning_(0),
+    seedBatchSize_(conf.existsAs<unsigned int>("seedBatchSize") ? conf.getParameter<unsigned int>("seedBatchSize") : 0),
     theMTELabel(iC.consumes<MeasurementTrackerEvent>(conf.getParameter<edm::InputTag>("MeasurementTrackerEvent"))),
     skipClusters_(false),
     phase2skipClusters_(false)
@@ -109,6 +109,13 @@ namespace cms{
     }
 #endif
 
+    // CkfTrajectoryBuilder caches the trajectories of the current seed
+    if (seedBatchSize_>0 && dynamic_cast<CkfTrajectoryBuilder const*>(theTrajectoryBuilder.get())) {
+      edm::LogWarning("CkfPattern") << "seedBatchSize ignored: " << conf.getParameter<edm::ParameterSet>("TrajectoryBuilderPSet").getParameter<std::string>("ComponentType")
+                                    << " cannot build several seeds concurrently";
+      seedBatchSize_ = 0;
+    }
+
 #ifdef VI_REPRODUCIBLE
    std::cout << "CkfTrackCandidateMaker in reproducible setting" << std::endl;
    assert(nullptr==theSeedCleaner);
@@ -266,6 +273,35 @@ namespace cms{
       // std::cout << spt(indeces[0]) << ' ' << spt(indeces[collseed_size-1]) << std::endl;
 #endif
 
+      // move the valid trajectories built from seed j to rawResult; returns true if the seed cleaner was updated
+      auto storeTrajectories = [&](unsigned int j, std::vector<Trajectory>& theTmpTrajectories) {
+        bool cleanerUpdated = false;
+	for(vector<Trajectory>::iterator it=theTmpTrajectories.begin();
+	    it!=theTmpTrajectories.end(); it++){
+	  if( it->isValid() ) {
+	    it->setSeedRef(collseed->refAt(j));
+            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NOT_STOPPED);
+	    // Store trajectory
+	    rawResult.push_back(std::move(*it));
+  	    // Tell seed cleaner which hits this trajectory used.
+            //TO BE FIXED: this cut should be configurable via cfi file
+            if (theSeedCleaner && rawResult.back().foundHits()>3) { theSeedCleaner->add( &rawResult.back() ); cleanerUpdated = true; }
+            //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
+	  }
+	}
+
+	LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
+
+	if ( maxSeedsBeforeCleaning_ >0 && rawResult.size() > maxSeedsBeforeCleaning_+lastCleanResult) {
+          theTrajectoryCleaner->clean(rawResult);
+          rawResult.erase(std::remove_if(rawResult.begin()+lastCleanResult,rawResult.end(),
+					 std::not1(std::mem_fun_ref(&Trajectory::isValid))),
+			  rawResult.end());
+          lastCleanResult=rawResult.size();
+        }
+        return cleanerUpdated;
+      };
+
       std::atomic<unsigned int> ntseed(0);
       auto theLoop = [&](size_t ii) {
         auto j = indeces[ii];
@@ -340,34 +376,11 @@ namespace cms{
 			       <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
 
         { Lock lock(theMutex);
-	for(vector<Trajectory>::iterator it=theTmpTrajectories.begin();
-	    it!=theTmpTrajectories.end(); it++){
-	  if( it->isValid() ) {
-	    it->setSeedRef(collseed->refAt(j));
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NOT_STOPPED);
-	    // Store trajectory
-	    rawResult.push_back(std::move(*it));
-  	    // Tell seed cleaner which hits this trajectory used.
-            //TO BE FIXED: this cut should be configurable via cfi file
-            if (theSeedCleaner && rawResult.back().foundHits()>3) theSeedCleaner->add( &rawResult.back() );
-            //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
-	  }
-	}}
+        storeTrajectories(j, theTmpTrajectories);
+        }
 
         theTmpTrajectories.clear();
 
-	LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
-
-        { Lock lock(theMutex);
-	if ( maxSeedsBeforeCleaning_ >0 && rawResult.size() > maxSeedsBeforeCleaning_+lastCleanResult) {
-          theTrajectoryCleaner->clean(rawResult);
-          rawResult.erase(std::remove_if(rawResult.begin()+lastCleanResult,rawResult.end(),
-					 std::not1(std::mem_fun_ref(&Trajectory::isValid))),
-			  rawResult.end());
-          lastCleanResult=rawResult.size();
-        }
-        }
-
       };
       // end of loop over seeds
 
@@ -375,12 +388,77 @@ namespace cms{
 #ifdef VI_TBB
      tbb::parallel_for(0UL,collseed_size,1UL,theLoop);
 #else
+      if (seedBatchSize_>0) {
+        // Build the seeds of a batch concurrently against the seed cleaner content at the start
+        // of the batch, then store the results in seed order. The seed cleaner only accumulates
+        // hits, so a seed rejected at the start of the batch would have been rejected by the serial
+        // loop too; a seed accepted then is checked again if tracks were added to the cleaner in the
+        // meantime, and its trajectories are dropped if it is now rejected. The output is thus the
+        // same as for the serial loop.
+        struct SeedBuild {
+          std::vector<Trajectory> trajectories;
+          unsigned int nCandPerSeed;
+          SeedStopReason stopReason;
+        };
+        std::vector<SeedBuild> builds(std::min<size_t>(seedBatchSize_, collseed_size));
+
+        auto buildSeed = [&](unsigned int j, SeedBuild & build) {
+          build.trajectories.clear();
+          build.nCandPerSeed = 0;
+          build.stopReason = SeedStopReason::NOT_STOPPED;
+
+          if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
+            build.stopReason = SeedStopReason::SEED_CLEANING;
+            return;
+          }
+
+          auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], build.trajectories, build.nCandPerSeed, nullptr );
+          if (build.trajectories.empty()) {
+            build.stopReason = SeedStopReason::NO_TRAJECTORY;
+            return;
+          }
+          if (cleanTrajectoryAfterInOut) theTrajectoryCleaner->clean(build.trajectories);
+          if (doSeedingRegionRebuilding) {
+            theTrajectoryBuilder->rebuildTrajectories(startTraj, (*collseed)[j], build.trajectories);
+            if (build.trajectories.empty()) {
+              build.stopReason = SeedStopReason::SEED_REGION_REBUILD;
+              return;
+            }
+          }
+          theTrajectoryCleaner->clean(build.trajectories);
+        };
+
+        for (size_t begin = 0; begin < collseed_size; begin += seedBatchSize_) {
+          size_t end = std::min<size_t>(begin + seedBatchSize_, collseed_size);
+          tbb::parallel_for(begin, end, [&](size_t ii) { buildSeed(indeces[ii], builds[ii-begin]); });
+
+          bool cleanerUpdated = false;
+          for (size_t ii = begin; ii < end; ++ii) {
+            auto j = indeces[ii];
+            auto & build = builds[ii-begin];
+            ++ntseed;
+            if (build.stopReason == SeedStopReason::SEED_CLEANING ||
+                (cleanerUpdated && !theSeedCleaner->good( &((*collseed)[j]))) ) {
+              LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+              (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+              continue;
+            }
+            (*outputSeedStopInfos)[j].setCandidatesPerSeed(build.nCandPerSeed);
+            if (build.stopReason != SeedStopReason::NOT_STOPPED) {
+              (*outputSeedStopInfos)[j].setStopReason(build.stopReason);
+              continue;
+            }
+            cleanerUpdated |= storeTrajectories(j, build.trajectories);
+          }
+        }
+      } else {
 #ifdef VI_OMP
 #pragma omp parallel for schedule(dynamic,4)
 #endif
       for (size_t j = 0; j < collseed_size; j++){
        theLoop(j);
       }
+      }
 #endif
       assert(ntseed==collseed_size);
       if (theSeedCleaner) theSeedCleaner->done();
@@ -86,11 +86,7 @@ private:
 		    reco::BeamSpot const & beamSpot,
 		    reco::VertexCollection const & vertices,
 		    MVACollection & mvas) const final {
-
-      size_t current = 0;
-      for (auto const & trk : tracks) {
-	mvas[current++]= mva(trk,beamSpot,vertices);
-      }
+      mva(tracks,beamSpot,vertices,mvas);
     }
 
   MVA mva;
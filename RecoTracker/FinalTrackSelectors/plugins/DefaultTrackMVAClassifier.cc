@@ -2,11 +2,14 @@
 
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Utilities/interface/Exception.h"
 #include "CondFormats/DataRecord/interface/GBRWrapperRcd.h"
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
 
 #include "DataFormats/TrackReco/interface/Track.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
 #include <limits>
+#include <vector>
 
 #include "getBestVertex.h"
 
@@ -16,31 +19,62 @@ namespace {
   
 template<bool PROMPT>
 struct mva {
+  static constexpr unsigned int nVars = PROMPT ? 16 : 12;
+
   mva(const edm::ParameterSet &cfg):
     forestLabel_    ( cfg.getParameter<std::string>("GBRForestLabel") ),
     dbFileName_     ( cfg.getParameter<std::string>("GBRForestFileName") ),
     useForestFromDB_( (!forestLabel_.empty()) & dbFileName_.empty())
-  {}
+  {
+    // the label names the forest both in the DB and in the file
+    if (forestLabel_.empty())
+      throw cms::Exception("Configuration") << name() << ": GBRForestLabel must be set, "
+                                            << "to read the forest from the DB or from GBRForestFileName";
+  }
 
   void beginStream() {
     if(!dbFileName_.empty()){
       TFile gbrfile(dbFileName_.c_str());
       forestFromFile_.reset((GBRForest*)gbrfile.Get(forestLabel_.c_str()));
+      if (!forestFromFile_)
+        throw cms::Exception("Configuration") << name() << ": no GBRForest " << forestLabel_
+                                              << " in " << dbFileName_;
+      evaluator_ = GBRForestEvaluator(*forestFromFile_);
     }
   }
 
   void initEvent(const edm::EventSetup& es) {
-    forest_ = forestFromFile_.get();
     if(useForestFromDB_){
-      edm::ESHandle<GBRForest> forestHandle;
-      es.get<GBRWrapperRcd>().get(forestLabel_,forestHandle);
-      forest_ = forestHandle.product();
+      // the evaluator is rebuilt only when the payload changes
+      auto cacheId = es.get<GBRWrapperRcd>().cacheIdentifier();
+      if (cacheId!=forestCacheId_) {
+        edm::ESHandle<GBRForest> forestHandle;
+        es.get<GBRWrapperRcd>().get(forestLabel_,forestHandle);
+        evaluator_ = GBRForestEvaluator(*forestHandle);
+        forestCacheId_ = cacheId;
+      }
     }
   }
 
-  float operator()(reco::Track const & trk,
-		   reco::BeamSpot const & beamSpot,
-		   reco::VertexCollection const & vertices) const {
+  void operator()(reco::TrackCollection const & tracks,
+		  reco::BeamSpot const & beamSpot,
+		  reco::VertexCollection const & vertices,
+		  std::vector<float> & mvas) const {
+    // fill the inputs of all tracks, then evaluate the forest on all of them
+    std::vector<float> gbrVals(tracks.size()*nVars);
+    for (size_t i=0; i<tracks.size(); ++i)
+      fillInputs(tracks[i],beamSpot,vertices,&gbrVals[i*nVars]);
+
+    std::vector<double> responses(tracks.size());
+    evaluator_.GetResponses(gbrVals.data(),tracks.size(),nVars,responses.data());
+    for (size_t i=0; i<tracks.size(); ++i)
+      mvas[i] = 2.0/(1.0+exp(-2.0*responses[i]))-1; // as GBRForest::GetClassifier
+  }
+
+  void fillInputs(reco::Track const & trk,
+		  reco::BeamSpot const & beamSpot,
+		  reco::VertexCollection const & vertices,
+		  float * gbrVals_) const {
 
     auto tmva_pt_ = trk.pt();
     auto tmva_ndof_ = trk.ndof();
@@ -72,7 +106,6 @@ struct mva {
     auto tmva_minlost_ = std::min(lostIn,lostOut);
     auto tmva_lostmidfrac_ = static_cast<float>(trk.numberOfLostHits()) / static_cast<float>(trk.numberOfValidHits() + trk.numberOfLostHits());
    
-    float gbrVals_[PROMPT ? 16 : 12];
     gbrVals_[0] = tmva_pt_;
     gbrVals_[1] = tmva_lostmidfrac_;
     gbrVals_[2] = tmva_minlost_;
@@ -98,11 +131,6 @@ struct mva {
       gbrVals_[14] = tmva_absdz_;
       gbrVals_[15] = tmva_absd0_;
     }
-
- 
-
-    return forest_->GetClassifier(gbrVals_);
-    
   }
 
   static const char * name();
@@ -113,7 +141,8 @@ struct mva {
   }
   
   std::unique_ptr<GBRForest> forestFromFile_;
-  const GBRForest *forest_ = nullptr; // owned by somebody else
+  GBRForestEvaluator evaluator_; // compiled forest if available
+  unsigned long long forestCacheId_ = 0;
   const std::string forestLabel_;
   const std::string dbFileName_;
   const bool useForestFromDB_;
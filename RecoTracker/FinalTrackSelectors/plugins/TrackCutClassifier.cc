@@ -178,6 +178,16 @@ namespace {
     void beginStream() {}
     void initEvent(const edm::EventSetup&) {}
     
+    void operator()(reco::TrackCollection const & tracks,
+		    reco::BeamSpot const & beamSpot,
+		    reco::VertexCollection const & vertices,
+		    std::vector<float> & mvas) const {
+      size_t current = 0;
+      for (auto const & trk : tracks) {
+	mvas[current++]= (*this)(trk,beamSpot,vertices);
+      }
+    }
+
     float operator()(reco::Track const & trk,
 		     reco::BeamSpot const & beamSpot,
 		     reco::VertexCollection const & vertices) const {
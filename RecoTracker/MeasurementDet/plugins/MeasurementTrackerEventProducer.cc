@@ -200,6 +200,7 @@ MeasurementTrackerEventProducer::updatePixels( const edm::Event& event, PxMeasur
       } else { 
 	
 	//std::cout <<"updatePixels "<<pixelCollection->dataSize()<<std::endl;
+	thePxDets.fillClusterBoxes();
 	pixelClustersToSkip.resize(pixelCollection->dataSize());
 	std::fill(pixelClustersToSkip.begin(),pixelClustersToSkip.end(),false);
 	
@@ -288,6 +289,7 @@ MeasurementTrackerEventProducer::updateStrips( const edm::Event& event, StMeasur
       }
     
       theStDets.handle() = clusterHandle;
+      theStDets.fillFirstStrips();
       int i=0;
       // cluster and det and in order (both) and unique so let's use set intersection
       for ( auto j = 0U; j< (*clusterCollection).size(); ++j) {
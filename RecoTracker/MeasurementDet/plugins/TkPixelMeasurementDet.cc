@@ -7,6 +7,7 @@
 #include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
 #include "TrackingTools/DetLayers/interface/MeasurementEstimator.h"
 #include "TrackingTools/PatternTools/interface/TrajMeasLessEstim.h"
+#include<cassert>
 
 
 namespace {
@@ -114,31 +115,43 @@ TkPixelMeasurementDet::compHits( const TrajectoryStateOnSurface& ts, const Measu
   int yplus = PPlus.y()+0.5f;
 
 
+  if (detSet.empty()) return result;
+  if (detSet.begin() < begin){
+    edm::LogError("IndexMisMatch")<<"TkPixelMeasurementDet cannot create hit because of index mismatch.";
+    return result;
+  }
+
+  // scan the bounding boxes, contiguous in memory, instead of the clusters
+  unsigned int first = detSet.begin()-begin;
+  auto const & boxes = data.pixelData().clusterBoxes();
+  assert(first+detSet.size() <= boxes.minRow.size());
+  auto const * minRow = boxes.minRow.data()+first;
+  auto const * maxRow = boxes.maxRow.data()+first;
+  auto const * minCol = boxes.minCol.data()+first;
+  auto const * maxCol = boxes.maxCol.data()+first;
+
   // rechits are sorted in x...
-  auto rightCluster = 
-    std::find_if( detSet.begin(), detSet.end(), [xplus](const SiPixelCluster& cl) { return cl.minPixelRow() > xplus; });
+  unsigned int nRight = 0;
+  while (nRight<detSet.size() && minRow[nRight]<=xplus) ++nRight;
 
-  // std::cout << "px xlim " << xl << ' ' << xminus << '/' << xplus << ' ' << rightCluster-detSet.begin() << ',' << detSet.end()-rightCluster << std::endl;
+  // std::cout << "px xlim " << xl << ' ' << xminus << '/' << xplus << ' ' << nRight << ',' << detSet.size()-nRight << std::endl;
   
 
   // consider only compatible clusters
- for (auto ci = detSet.begin(); ci != rightCluster; ++ci ) {    
+  for (unsigned int k = 0; k != nRight; ++k) {
 
-    if (ci < begin){
-      edm::LogError("IndexMisMatch")<<"TkPixelMeasurementDet cannot create hit because of index mismatch.";
-      return result;
-    }
-     unsigned int index = ci-begin;
+     if (maxRow[k]<xminus) continue;
+     // also check compatibility in y... (does not add much)
+     if (minCol[k]>yplus) continue;
+     if (maxCol[k]<yminus) continue;
+
+     auto ci = detSet.begin()+k;
+     unsigned int index = first+k;
      if (!data.pixelClustersToSkip().empty() &&  index>=data.pixelClustersToSkip().size()){
        edm::LogError("IndexMisMatch")<<"TkPixelMeasurementDet cannot create hit because of index mismatch. i.e "<<index<<" >= "<<data.pixelClustersToSkip().size();
        return result;
      }
 
-     if (ci->maxPixelRow()<xminus) continue;
-     // also check compatibility in y... (does not add much)
-     if (ci->minPixelCol()>yplus) continue;
-     if (ci->maxPixelCol()<yminus) continue;
-
      if(data.pixelClustersToSkip().empty() or (not data.pixelClustersToSkip()[index]) ) {
        SiPixelClusterRef cluster = detSet.makeRefTo( data.pixelData().handle(), ci );
        result.push_back( buildRecHit( cluster, ts.localParameters() ) );
@@ -68,8 +68,7 @@ bool TkStripMeasurementDet::recHits(SimpleHitContainer & result,
   const detset & detSet = data.stripData().detSet(index());
   auto const & cpepar = cpe()->getAlgoParam(specificGeomDet(),stateOnThisDet.localParameters());
 
-  auto rightCluster = 
-    std::find_if( detSet.begin(), detSet.end(), [utraj](const SiStripCluster& hit) { return hit.firstStrip() > utraj; });
+  auto rightCluster = data.stripData().firstClusterAfter(detSet, utraj);
   
   
   std::vector<SiStripRecHit2D> tmp;
@@ -109,8 +108,7 @@ bool TkStripMeasurementDet::simpleRecHits( const TrajectoryStateOnSurface& state
   const detset & detSet = data.stripData().detSet(index());
   auto const & cpepar = cpe()->getAlgoParam(specificGeomDet(),stateOnThisDet.localParameters());
   
-  auto rightCluster = 
-    std::find_if( detSet.begin(), detSet.end(), [utraj](const SiStripCluster& hit) { return hit.firstStrip() > utraj; });
+  auto rightCluster = data.stripData().firstClusterAfter(detSet, utraj);
   
   if ( rightCluster != detSet.begin()) {
     // there are hits on the left of the utraj
@@ -143,8 +141,7 @@ TkStripMeasurementDet::recHits( const TrajectoryStateOnSurface& stateOnThisDet,
   int utraj =  specificGeomDet().specificTopology().measurementPosition( stateOnThisDet.localPosition()).x();
  
     const detset & detSet = data.stripData().detSet(index()); 
-    auto rightCluster = 
-      std::find_if( detSet.begin(), detSet.end(), [utraj](const SiStripCluster& hit) { return hit.firstStrip() > utraj; });
+    auto rightCluster = data.stripData().firstClusterAfter(detSet, utraj);
     
     if ( rightCluster != detSet.begin()) {
       // there are hits on the left of the utraj
@@ -23,6 +23,7 @@ class Phase2StripCPE;
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
 #include <unordered_map>
+#include <algorithm>
 
 // #define VISTAT
 
@@ -213,6 +214,28 @@ public:
   const edm::Handle<edmNew::DetSetVector<SiStripCluster> > & handle() const {  return handle_; }
   // StripDetset & detSet(int i) { return detSet_[i]; }
   const StripDetset & detSet(int i) const { if (ready_[i]) const_cast<StMeasurementDetSet*>(this)->getDetSet(i);     return detSet_[i]; }
+
+  /// copy the first strip of all the clusters of the event in a contiguous array,
+  /// so that the clusters of a det can be searched without touching them
+  void fillFirstStrips() {
+    auto const & clusters = handle_->data();
+    firstStrip_.resize(clusters.size());
+    for (auto j=0U; j<clusters.size(); ++j) firstStrip_[j] = clusters[j].firstStrip();
+  }
+
+  /// first cluster of the det set starting after strip utraj (end() if none)
+  new_const_iterator firstClusterAfter(const StripDetset & detSet, int utraj) const {
+    auto b = detSet.begin();
+    auto n = detSet.size();
+    // the det set is a view of the event collection: use the contiguous copy
+    if (n>0 && detSet.offset()+n<=firstStrip_.size() && b==&handle_->data()[detSet.offset()]) {
+      auto const * fs = firstStrip_.data()+detSet.offset();
+      unsigned int k=0;
+      while (k<n && fs[k]<=utraj) ++k;
+      return b+k;
+    }
+    return std::find_if(b, detSet.end(), [utraj](const SiStripCluster& hit) { return hit.firstStrip() > utraj; });
+  }
   
 
   //// ------- pieces for on-demand unpacking -------- 
@@ -256,6 +279,9 @@ private:
   std::vector<bool> empty_;
   std::vector<bool> activeThisEvent_;
   
+  // first strip of each cluster of handle_, indexed by cluster key
+  std::vector<uint16_t> firstStrip_;
+
   // full reco
   std::vector<StripDetset> detSet_;
   std::vector<int> detIndex_;
@@ -404,6 +430,22 @@ public:
   const edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() const {  return handle_;}
   edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() {  return handle_;}
   const PixelDetSet & detSet(int i) const { return detSet_[i];}
+
+  /// pixel bounding boxes of all the clusters of the event, indexed by cluster key
+  struct ClusterBoxes {
+    std::vector<uint16_t> minRow, maxRow, minCol, maxCol;
+  };
+  void fillClusterBoxes() {
+    auto const & clusters = handle_->data();
+    auto n = clusters.size();
+    boxes_.minRow.resize(n); boxes_.maxRow.resize(n); boxes_.minCol.resize(n); boxes_.maxCol.resize(n);
+    for (auto j=0U; j<n; ++j) {
+      auto const & cl = clusters[j];
+      boxes_.minRow[j] = cl.minPixelRow(); boxes_.maxRow[j] = cl.maxPixelRow();
+      boxes_.minCol[j] = cl.minPixelCol(); boxes_.maxCol[j] = cl.maxPixelCol();
+    }
+  }
+  const ClusterBoxes & clusterBoxes() const { return boxes_; }
 private:
   friend class MeasurementTrackerImpl;
 
@@ -417,6 +459,7 @@ private:
   std::vector<bool> empty_;
   std::vector<bool> activeThisEvent_;
   std::unordered_map<int, BadFEDChannelPositions> badFEDChannelPositionsSet_;
+  ClusterBoxes boxes_;
 };
 
 //FIXME:just temporary solution for phase2 OT that works!
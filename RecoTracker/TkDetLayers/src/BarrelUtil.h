@@ -10,6 +10,9 @@
 #include "TrackingTools/DetLayers/interface/PhiLess.h"
 #include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
 
+#include <cmath>
+#include <vector>
+
 #pragma GCC visibility push(hidden)
 namespace barrelUtil {
 
@@ -55,7 +58,31 @@ namespace barrelUtil {
     
     return rangesIntersect(phiRange, gsdet.surface().phiSpan(), PhiLess());
   } 
-  
+
+
+  /// geometry of a det of a rod needed by overlapInZ, computed once at construction
+  struct RodDetPar { GlobalPoint pos; GlobalVector yAxis; float halfLength; };
+
+  inline
+  void fillRodDetPars(std::vector<const GeomDet*> const & dets, std::vector<RodDetPar> & pars) {
+    pars.clear();
+    pars.reserve(dets.size());
+    for (auto det : dets) {
+      auto const & plane = det->surface();
+      RodDetPar apar = { plane.position(), GlobalVector(plane.rotation().y()), 0.5f*plane.bounds().length() };
+      pars.push_back(apar);
+    }
+  }
+
+  inline
+  bool overlapInZ( const GlobalPoint& crossPoint, const RodDetPar & dpar, float window) {
+    // check if the z window around TSOS overlaps with the detector (with a 1% margin added);
+    // same as comparing det.surface().toLocal(crossPoint).y() with the det half length
+    constexpr float relativeMargin = 1.01;
+    float localY = (crossPoint-dpar.pos).dot(dpar.yAxis);
+    return (std::abs(localY)-window) < relativeMargin*dpar.halfLength;
+  }
+
 
 }
 
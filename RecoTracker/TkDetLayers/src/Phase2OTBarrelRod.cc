@@ -49,6 +49,8 @@ Phase2OTBarrelRod::Phase2OTBarrelRod(vector<const GeomDet*>& innerDets,
 
   theInnerBinFinder = BinFinderType(theInnerDets.begin(), theInnerDets.end());
   theOuterBinFinder = BinFinderType(theOuterDets.begin(), theOuterDets.end());
+  barrelUtil::fillRodDetPars(theInnerDets, theInnerPars);
+  barrelUtil::fillRodDetPars(theOuterDets, theOuterPars);
 
 
  
@@ -258,32 +260,6 @@ float Phase2OTBarrelRod::computeWindowSize( const GeomDet* det,
 
 
 
-namespace {
-
-  inline
-  bool overlap( const GlobalPoint& crossPoint, const GeomDet& det, float window) {
-    // check if the z window around TSOS overlaps with the detector theDet (with a 1% margin added)
-    
-    //   const float tolerance = 0.1;
-    constexpr float relativeMargin = 1.01;
-    
-    LocalPoint localCrossPoint( det.surface().toLocal(crossPoint));
-    //   if (std::abs(localCrossPoint.z()) > tolerance) {
-    //     edm::LogInfo(TkDetLayers) << "TOBRod::overlap calculation assumes point on surface, but it is off by "
-    // 	 << localCrossPoint.z() ;
-    //   }
-    
-    float localY = localCrossPoint.y();
-    float detHalfLength = 0.5f*det.surface().bounds().length();
-    
-    //   edm::LogInfo(TkDetLayers) << "TOBRod::overlap: Det at " << det.position() << " hit at " << localY 
-    //        << " Window " << window << " halflength "  << detHalfLength ;
-    
-    return (std::abs(localY)-window) < relativeMargin*detHalfLength;
-    
-  }
-
-}
 
 
 void Phase2OTBarrelRod::searchNeighbors( const TrajectoryStateOnSurface& tsos,
@@ -298,6 +274,7 @@ void Phase2OTBarrelRod::searchNeighbors( const TrajectoryStateOnSurface& tsos,
   const GlobalPoint& gCrossingPos = crossing.position();
 
   const vector<const GeomDet*>& sRod( subRod( crossing.subLayerIndex()));
+  const vector<barrelUtil::RodDetPar>& sPars( subRodPars( crossing.subLayerIndex()));
   const vector<const GeomDet*>& sBrotherRod( subRodBrothers( crossing.subLayerIndex()));
  
   int closestIndex = crossing.closestDetIndex();
@@ -315,13 +292,13 @@ void Phase2OTBarrelRod::searchNeighbors( const TrajectoryStateOnSurface& tsos,
 
   typedef CompatibleDetToGroupAdder Adder;
   for (int idet=negStartIndex; idet >= 0; idet--) {
-    if (!overlap( gCrossingPos, *sRod[idet], window)) break;
+    if (!barrelUtil::overlapInZ( gCrossingPos, sPars[idet], window)) break;
     if (!Adder::add( *sRod[idet], tsos, prop, est, result)) break;
     // If the two above checks are passed also the brother module will be added with no further checks
     Adder::add( *sBrotherRod[idet], tsos, prop, est, brotherresult);
   }
   for (int idet=posStartIndex; idet < static_cast<int>(sRod.size()); idet++) {
-    if (!overlap( gCrossingPos, *sRod[idet], window)) break;
+    if (!barrelUtil::overlapInZ( gCrossingPos, sPars[idet], window)) break;
     if (!Adder::add( *sRod[idet], tsos, prop, est, result)) break;
     // If the two above checks are passed also the brother module will be added with no further checks
     Adder::add( *sBrotherRod[idet], tsos, prop, est, brotherresult);
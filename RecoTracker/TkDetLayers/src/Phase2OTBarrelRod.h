@@ -6,6 +6,7 @@
 #include "TrackingTools/DetLayers/interface/DetRod.h"
 #include "Utilities/BinningTools/interface/GenericBinFinderInZ.h"
 #include "SubLayerCrossings.h"
+#include "BarrelUtil.h"
 
 
 /** A concrete implementation for TOB Rod 
@@ -71,6 +72,10 @@ class Phase2OTBarrelRod final : public DetRod {
     return (ind==0 ? theInnerDets : theOuterDets);
   }
 
+  const std::vector<barrelUtil::RodDetPar>& subRodPars( int ind) const {
+    return (ind==0 ? theInnerPars : theOuterPars);
+  }
+
   const std::vector<const GeomDet*>& subRodBrothers( int ind) const {
     return (ind==0 ? theInnerDetBrothers : theOuterDetBrothers);
   }
@@ -80,6 +85,8 @@ class Phase2OTBarrelRod final : public DetRod {
   std::vector<const GeomDet*> theDets;
   std::vector<const GeomDet*> theInnerDets;
   std::vector<const GeomDet*> theOuterDets;
+  std::vector<barrelUtil::RodDetPar> theInnerPars;
+  std::vector<barrelUtil::RodDetPar> theOuterPars;
   std::vector<const GeomDet*> theInnerDetBrothers;
   std::vector<const GeomDet*> theOuterDetBrothers;
 
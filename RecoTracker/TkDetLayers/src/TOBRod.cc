@@ -46,6 +46,8 @@ TOBRod::TOBRod(vector<const GeomDet*>& innerDets,
   sort(theOuterDets.begin(),theOuterDets.end(),DetZLess());
   theInnerBinFinder = BinFinderType(theInnerDets.begin(), theInnerDets.end());
   theOuterBinFinder = BinFinderType(theOuterDets.begin(), theOuterDets.end());
+  barrelUtil::fillRodDetPars(theInnerDets, theInnerPars);
+  barrelUtil::fillRodDetPars(theOuterDets, theOuterPars);
 
 
  
@@ -198,32 +200,6 @@ float TOBRod::computeWindowSize( const GeomDet* det,
 
 
 
-namespace {
-
-  inline
-  bool overlap( const GlobalPoint& crossPoint, const GeomDet& det, float window) {
-    // check if the z window around TSOS overlaps with the detector theDet (with a 1% margin added)
-    
-    //   const float tolerance = 0.1;
-    constexpr float relativeMargin = 1.01;
-    
-    LocalPoint localCrossPoint( det.surface().toLocal(crossPoint));
-    //   if (std::abs(localCrossPoint.z()) > tolerance) {
-    //     edm::LogInfo(TkDetLayers) << "TOBRod::overlap calculation assumes point on surface, but it is off by "
-    // 	 << localCrossPoint.z() ;
-    //   }
-    
-    float localY = localCrossPoint.y();
-    float detHalfLength = 0.5f*det.surface().bounds().length();
-    
-    //   edm::LogInfo(TkDetLayers) << "TOBRod::overlap: Det at " << det.position() << " hit at " << localY 
-    //        << " Window " << window << " halflength "  << detHalfLength ;
-    
-    return (std::abs(localY)-window) < relativeMargin*detHalfLength;
-    
-  }
-
-}
 
 void TOBRod::searchNeighbors( const TrajectoryStateOnSurface& tsos,
 			      const Propagator& prop,
@@ -236,6 +212,7 @@ void TOBRod::searchNeighbors( const TrajectoryStateOnSurface& tsos,
   const GlobalPoint& gCrossingPos = crossing.position();
 
   const vector<const GeomDet*>& sRod( subRod( crossing.subLayerIndex()));
+  const vector<barrelUtil::RodDetPar>& sPars( subRodPars( crossing.subLayerIndex()));
  
   int closestIndex = crossing.closestDetIndex();
   int negStartIndex = closestIndex-1;
@@ -252,11 +229,11 @@ void TOBRod::searchNeighbors( const TrajectoryStateOnSurface& tsos,
 
   typedef CompatibleDetToGroupAdder Adder;
   for (int idet=negStartIndex; idet >= 0; idet--) {
-    if (!overlap( gCrossingPos, *sRod[idet], window)) break;
+    if (!barrelUtil::overlapInZ( gCrossingPos, sPars[idet], window)) break;
     if (!Adder::add( *sRod[idet], tsos, prop, est, result)) break;
   }
   for (int idet=posStartIndex; idet < static_cast<int>(sRod.size()); idet++) {
-    if (!overlap( gCrossingPos, *sRod[idet], window)) break;
+    if (!barrelUtil::overlapInZ( gCrossingPos, sPars[idet], window)) break;
     if (!Adder::add( *sRod[idet], tsos, prop, est, result)) break;
   }
 }
@@ -6,6 +6,7 @@
 #include "TrackingTools/DetLayers/interface/DetRod.h"
 #include "TrackingTools/DetLayers/interface/PeriodicBinFinderInZ.h"
 #include "SubLayerCrossings.h"
+#include "BarrelUtil.h"
 
 
 /** A concrete implementation for TOB Rod 
@@ -68,11 +69,17 @@ class TOBRod final : public DetRod {
     return (ind==0 ? theInnerDets : theOuterDets);
   }
 
+  const std::vector<barrelUtil::RodDetPar>& subRodPars( int ind) const {
+    return (ind==0 ? theInnerPars : theOuterPars);
+  }
+
 
  private:
   std::vector<const GeomDet*> theDets;
   std::vector<const GeomDet*> theInnerDets;
   std::vector<const GeomDet*> theOuterDets;
+  std::vector<barrelUtil::RodDetPar> theInnerPars;
+  std::vector<barrelUtil::RodDetPar> theOuterPars;
 
   ReferenceCountingPointer<Plane> theInnerPlane;
   ReferenceCountingPointer<Plane> theOuterPlane;
@@ -140,6 +140,18 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
     if(!checkRZ) continue;
 
     Kernels<HitZCheck,HitRCheck,HitEtaCheck> kernels;
+    auto const algo = checkRZ->algo();
+    switch (algo) {
+      case (HitRZCompatibility::zAlgo) :
+	std::get<0>(kernels).set(checkRZ);
+	break;
+      case (HitRZCompatibility::rAlgo) :
+	std::get<1>(kernels).set(checkRZ);
+	break;
+      case (HitRZCompatibility::etaAlgo) :
+	std::get<2>(kernels).set(checkRZ);
+	break;
+    }
 
     auto innerRange = innerHitsMap.doubleRange(phiRange.min(), phiRange.max());
     LogDebug("HitPairGeneratorFromLayerPair")<<
@@ -147,30 +159,32 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 				      <<" inner and: "<< outerHitsMap.theHits.size()<<" outter";
     for(int j=0; j<3; j+=2) {
       auto b = innerRange[j]; auto e=innerRange[j+1];
+      if (b==e) continue;
       bool ok[e-b];
-      switch (checkRZ->algo()) {
+      switch (algo) {
 	case (HitRZCompatibility::zAlgo) :
-	  std::get<0>(kernels).set(checkRZ);
 	  std::get<0>(kernels)(b,e,innerHitsMap, ok);
 	  break;
 	case (HitRZCompatibility::rAlgo) :
-	  std::get<1>(kernels).set(checkRZ);
 	  std::get<1>(kernels)(b,e,innerHitsMap, ok);
 	  break;
 	case (HitRZCompatibility::etaAlgo) :
-	  std::get<2>(kernels).set(checkRZ);
 	  std::get<2>(kernels)(b,e,innerHitsMap, ok);
 	  break;
       }
+      // count the compatible hits first (vectorized), so that the size limit
+      // is checked once per range and not for each pair
+      int nOk = 0;
+      for (int i=0; i!=e-b; ++i) nOk += ok[i];
+      if (nOk==0) continue;
+      if (theMaxElement!=0 && result.size()+nOk > theMaxElement){
+	result.clear();
+	edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
+	delete checkRZ;
+	return;
+      }
       for (int i=0; i!=e-b; ++i) {
-	if (!ok[i]) continue;
-	if (theMaxElement!=0 && result.size() >= theMaxElement){
-	  result.clear();
-	  edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
-	  delete checkRZ;
-	  return;
-	}
-        result.add(b+i,io);
+	if (ok[i]) result.add(b+i,io);
       }
     }
     delete checkRZ;
@@ -575,21 +575,30 @@ AdaptiveVertexFitter::fit( const vector<RefCountedVertexTrack> & tracks,
       globalVTracks = reWeightTracks( globalVTracks, returnVertex );
     }
     // cout << "[AdaptiveVertexFit] relinarized, reweighted" << endl;
-    // update sequentially the vertex estimate
-    CachingVertex<5> nVertex;
+    // update sequentially the vertex estimate; only the state and chi2 are
+    // updated, the tracks accepted are put in the vertex once at the end
+    VertexState fState = fVertex.vertexState();
+    float fChi2 = fVertex.totalChiSquared();
+    const VertexState * fPrior = fVertex.hasPrior() ? &fVertex.priorVertexState() : nullptr;
+    VertexState nState;
+    float nChi2 = 0.;
+    vector<RefCountedVertexTrack> fTracks;
+    fTracks.reserve(globalVTracks.size());
     for(vector<RefCountedVertexTrack>::const_iterator i
           = globalVTracks.begin(); i != globalVTracks.end(); i++)
     {
-      if ((**i).weight() > 0.) nVertex = theUpdator->add( fVertex, *i );
-	else  nVertex = fVertex;
-      if (nVertex.isValid()) {
+      bool added = (**i).weight() > 0.;
+      bool valid = true;
+      if (added) valid = theUpdator->addToState( fState, fChi2, fPrior, *i, nState, nChi2 );
+	else { nState = fState; nChi2 = fChi2; }
+      if (valid) {
         if ( (**i).weight() >= theWeightThreshold ) ns_trks++;
         
-        if ( fabs ( nVertex.position().z() ) > 10000. ||
-             nVertex.position().perp()>120.)
+        if ( fabs ( nState.position().z() ) > 10000. ||
+             nState.position().perp()>120.)
         {
           // were more than 100 m off!!
-          LogInfo ("AdaptiveVertexFitter" ) << "Vertex candidate just took off to " << nVertex.position()
+          LogInfo ("AdaptiveVertexFitter" ) << "Vertex candidate just took off to " << nState.position()
 					    << "! Will discard this update!";
 // 	    //<< "track pt was " << (**i).linearizedTrack()->track().pt()
 // 					     << "track momentum was " << (**i).linearizedTrack()->track().initialFreeState().momentum()
@@ -599,7 +608,9 @@ AdaptiveVertexFitter::fit( const vector<RefCountedVertexTrack> & tracks,
 // 					     << "track w was " << (**i).weight()
 // 					     << "track schi2 was " << (**i).smoothedChi2();
         } else {
-	        fVertex = nVertex;
+	        fState = nState;
+	        fChi2 = nChi2;
+	        if (added) fTracks.push_back(*i);
         }
       } else {
         LogInfo("RecoVertex/AdaptiveVertexFitter") 
@@ -608,6 +619,13 @@ AdaptiveVertexFitter::fit( const vector<RefCountedVertexTrack> & tracks,
 	        << ".\n Your vertex might just have lost one good track.";
       }
     }
+    if (!fTracks.empty()) {
+      if (fVertex.hasPrior()) {
+        fVertex = CachingVertex<5>( fVertex.priorVertexState(), fState, fTracks, fChi2 );
+      } else {
+        fVertex = CachingVertex<5>( fState, fTracks, fChi2 );
+      }
+    }
     previousPosition = newPosition;
     newPosition = fVertex.position();
     returnVertex = fVertex;
@@ -0,0 +1,165 @@
+// Check that the sequential filter of AdaptiveVertexFitter::fit, which
+// updates the vertex state and chi2 with VertexUpdator::addToState and
+// builds the CachingVertex once, gives the same vertex as the filter it
+// replaced, which called VertexUpdator::add for each track. Done with the
+// Kalman updator, without and with prior, and with the Gaussian-sum updator
+// on multi-component tracks with a prior, where add collapses the vertex
+// state to a single component after each track.
+
+#include "RecoVertex/KalmanVertexFit/interface/KalmanVertexUpdator.h"
+#include "RecoVertex/GaussianSumVertexFit/interface/GsfVertexUpdator.h"
+#include "RecoVertex/GaussianSumVertexFit/interface/MultiPerigeeLTSFactory.h"
+#include "RecoVertex/VertexTools/interface/LinearizedTrackStateFactory.h"
+#include "RecoVertex/VertexTools/interface/VertexTrackFactory.h"
+#include "RecoVertex/VertexPrimitives/interface/CachingVertex.h"
+
+#include "TrackingTools/TransientTrack/interface/TransientTrack.h"
+#include "TrackingTools/GsfTools/interface/BasicMultiTrajectoryState.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+  typedef CachingVertex<5>::RefCountedVertexTrack RefCountedVertexTrack;
+  typedef VertexTrack<5>::RefCountedLinearizedTrackState RefCountedLinearizedTrackState;
+
+  class ConstMagneticField : public MagneticField {
+  public:
+    GlobalVector inTesla(const GlobalPoint&) const override { return GlobalVector(0,0,3.8); }
+  };
+
+  const GlobalPoint vertexPosition(0.01,-0.02,0.5);
+  const float weights[] = {1.f, 0.9f, 0.f, 0.7f, 1.f, 0.4f, 0.95f, 0.f};
+  constexpr unsigned int nTracks = 8;
+
+  reco::Track makeTrack(unsigned int i) {
+    double pt = 1.+0.5*i;
+    double phi = -3.+0.7*i;
+    double eta = 0.1+0.2*i;
+    reco::TrackBase::CovarianceMatrix cov;
+    double diag[5] = {1.e-6/(pt*pt), 1.e-6, 1.e-6, 1.e-4, 1.e-4};
+    for (unsigned int j=0; j<5; ++j) cov(j,j) = diag[j];
+    math::XYZPoint ref(vertexPosition.x()+0.002*i, vertexPosition.y()-0.001*i, vertexPosition.z()+0.01*i);
+    math::XYZVector mom(pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta));
+    return reco::Track(10., 8., ref, mom, i%2 ? 1 : -1, cov);
+  }
+
+  // three components on a plane through the reference point of the track,
+  // all with positive pz
+  TrajectoryStateOnSurface makeMixture(const reco::Track & track, const MagneticField * field) {
+    GlobalPoint ref(track.vx(), track.vy(), track.vz());
+    auto plane = Plane::build(ref, Surface::RotationType());
+    GlobalVector mom(track.px(), track.py(), track.pz());
+    AlgebraicSymMatrix55 err;
+    double diag[5] = {1.e-6/track.pt()/track.pt(), 1.e-6, 1.e-6, 1.e-4, 1.e-4};
+    const double w[3] = {0.5, 0.3, 0.2};
+    std::vector<TrajectoryStateOnSurface> components;
+    for (unsigned int c=0; c<3; ++c) {
+      for (unsigned int j=0; j<5; ++j) err(j,j) = diag[j]*(1.+c);
+      GlobalTrajectoryParameters gtp(ref+GlobalVector(0.002*c,-0.001*c,0.), mom*(1.+0.02*c),
+                                     track.charge(), field);
+      components.push_back(TrajectoryStateOnSurface(w[c], gtp, CurvilinearTrajectoryError(err), *plane));
+    }
+    return TrajectoryStateOnSurface((BasicTrajectoryState *)(new BasicMultiTrajectoryState(components)));
+  }
+
+  // the filter before addToState
+  CachingVertex<5> addFilter(const VertexUpdator<5> & updator, const CachingVertex<5> & initial,
+                             const std::vector<RefCountedVertexTrack> & tracks) {
+    CachingVertex<5> fVertex = initial;
+    for (auto const & track : tracks) {
+      CachingVertex<5> nVertex = track->weight()>0. ? updator.add(fVertex, track) : fVertex;
+      if (nVertex.isValid()) fVertex = nVertex;
+    }
+    return fVertex;
+  }
+
+  // the filter of AdaptiveVertexFitter::fit
+  CachingVertex<5> addToStateFilter(const VertexUpdator<5> & updator, const CachingVertex<5> & initial,
+                                    const std::vector<RefCountedVertexTrack> & tracks) {
+    VertexState fState = initial.vertexState();
+    float fChi2 = initial.totalChiSquared();
+    const VertexState * fPrior = initial.hasPrior() ? &initial.priorVertexState() : nullptr;
+    std::vector<RefCountedVertexTrack> fTracks;
+    for (auto const & track : tracks) {
+      VertexState nState;
+      float nChi2 = 0.;
+      if (track->weight()>0. && updator.addToState(fState, fChi2, fPrior, track, nState, nChi2)) {
+        fState = nState;
+        fChi2 = nChi2;
+        fTracks.push_back(track);
+      }
+    }
+    if (fTracks.empty()) return initial;
+    if (initial.hasPrior()) return CachingVertex<5>(initial.priorVertexState(), fState, fTracks, fChi2);
+    return CachingVertex<5>(fState, fTracks, fChi2);
+  }
+
+  unsigned int compare(const char * name, const CachingVertex<5> & before, const CachingVertex<5> & after) {
+    unsigned int nBad = 0;
+    if (!before.isValid() || !after.isValid()) {
+      std::cout << name << ": invalid vertex" << std::endl;
+      return 1;
+    }
+    if (!(before.position()==after.position())) ++nBad;
+    auto eb = before.error().matrix();
+    auto ea = after.error().matrix();
+    for (unsigned int i=0; i<3; ++i)
+      for (unsigned int j=0; j<=i; ++j)
+        if (eb(i,j)!=ea(i,j)) ++nBad;
+    if (before.totalChiSquared()!=after.totalChiSquared()) ++nBad;
+    if (before.tracks().size()!=after.tracks().size()) ++nBad;
+    if (before.vertexState().components().size()!=after.vertexState().components().size()) ++nBad;
+    if (before.hasPrior()!=after.hasPrior()) ++nBad;
+    std::cout << name << ": " << after.position() << " chi2 " << after.totalChiSquared()
+              << " components " << after.vertexState().components().size()
+              << (nBad ? " differs" : " same") << std::endl;
+    return nBad;
+  }
+}
+
+int main() {
+  ConstMagneticField field;
+  LinearizedTrackStateFactory ltsFactory;
+  MultiPerigeeLTSFactory multiLtsFactory;
+  VertexTrackFactory<5> vtFactory;
+
+  GlobalPoint priorPosition(0.,0.,0.4);
+  GlobalError priorError(0.01,0.,0.01,0.,0.,1.);
+  VertexState seed(priorPosition, priorError);
+  std::vector<RefCountedVertexTrack> none;
+  CachingVertex<5> noPrior(priorPosition, priorError, none, 0);
+  CachingVertex<5> withPrior(priorPosition, priorError, priorPosition, priorError, none, 0);
+
+  std::vector<RefCountedVertexTrack> singleTracks, mixtureTracks;
+  for (unsigned int i=0; i<nTracks; ++i) {
+    reco::Track track = makeTrack(i);
+    reco::TransientTrack ttrack(track, &field);
+    RefCountedLinearizedTrackState lts = ltsFactory.linearizedTrackState(priorPosition, ttrack);
+    singleTracks.push_back(vtFactory.vertexTrack(lts, seed, weights[i]));
+    RefCountedLinearizedTrackState mlts =
+      multiLtsFactory.linearizedTrackState(priorPosition, ttrack, makeMixture(track, &field));
+    mixtureTracks.push_back(vtFactory.vertexTrack(mlts, seed, weights[i]));
+  }
+
+  unsigned int nBad = 0;
+  KalmanVertexUpdator<5> kalman;
+  nBad += compare("Kalman", addFilter(kalman, noPrior, singleTracks),
+                  addToStateFilter(kalman, noPrior, singleTracks));
+  nBad += compare("Kalman with prior", addFilter(kalman, withPrior, singleTracks),
+                  addToStateFilter(kalman, withPrior, singleTracks));
+  GsfVertexUpdator gsf;
+  nBad += compare("GSF with prior", addFilter(gsf, withPrior, mixtureTracks),
+                  addToStateFilter(gsf, withPrior, mixtureTracks));
+
+  if (nBad>0) {
+    std::cout << nBad << " failures" << std::endl;
+    return 1;
+  }
+  return 0;
+}
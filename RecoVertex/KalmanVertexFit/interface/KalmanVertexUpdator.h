@@ -33,6 +33,14 @@ public:
    CachingVertex<N> remove(const CachingVertex<N> & oldVertex,
         const RefCountedVertexTrack track) const override;
 
+/**
+ *  Method adding a track to a vertex state, without the track container
+ */
+
+   bool addToState(const VertexState & oldState, float oldChi2,
+        const VertexState * priorState, const RefCountedVertexTrack track,
+        VertexState & newState, float & newChi2) const override;
+
 /**
  * Clone method
  */
@@ -70,6 +70,29 @@ CachingVertex<N> KalmanVertexUpdator<N>::remove(const CachingVertex<N> & oldVert
 }
 
 
+template <unsigned int N>
+bool KalmanVertexUpdator<N>::addToState(const VertexState & oldState, float oldChi2,
+    const VertexState * priorState, const RefCountedVertexTrack track,
+    VertexState & newState, float & newChi2) const
+{
+  // same as update(), without copying the tracks of the vertex;
+  // the prior does not enter the update
+  float weight = track->weight();
+  VertexState newVertexState = positionUpdate(oldState, track->linearizedTrack(), weight, +1);
+  if (!newVertexState.isValid()) return false;
+
+  float chi1 = oldChi2;
+  std::pair <bool, double> chi2P = chi2Increment(oldState, newVertexState,
+                             track->linearizedTrack() , weight );
+  if (!chi2P.first) return false;
+
+  chi1 += chi2P.second;
+  newState = newVertexState;
+  newChi2 = chi1;
+  return true;
+}
+
+
 template <unsigned int N>
 VertexState 
 KalmanVertexUpdator<N>::positionUpdate (const VertexState & oldVertex,
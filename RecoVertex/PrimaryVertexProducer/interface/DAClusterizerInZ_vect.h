@@ -77,6 +77,8 @@ public:
     std::vector<double> se;
     std::vector<double> swE;
     
+    // per-block partial sums of update, kept between the annealing steps
+    std::vector<double> blockSums;
     
     unsigned int GetSize() const
     {
@@ -18,6 +18,49 @@
 
 #include "RecoVertex/VertexTools/interface/GeometricAnnealing.h"
 
+#include <cmath>
+
+namespace {
+  // time of a fitted vertex: mean of the track times weighted by the weight of
+  // the track in the fit and by its time resolution, where tracks incompatible
+  // with the vertex time are down-weighted with the same Fermi function as the
+  // adaptive fit; returns false if no track constrains the time
+  bool fitVertexTime(const TransientVertex & v, double & time, double & timeError) {
+    constexpr double chi2cutoff = 3.*3.;
+    constexpr unsigned int maxIterations = 10;
+    const auto & tracks = v.originalTracks();
+    std::vector<double> w(tracks.size()), inverr2(tracks.size());
+    for (unsigned int i = 0; i < tracks.size(); ++i) {
+      const double inverr = 1.0/tracks[i].dtErrorExt();
+      inverr2[i] = inverr*inverr;
+      w[i] = (v.hasTrackWeight() ? v.trackWeight(tracks[i]) : 1.) * inverr2[i];
+    }
+
+    double t = 0., sumw = 0.;
+    for (unsigned int iter = 0; iter <= maxIterations; ++iter) {
+      double sumwt = 0.;
+      sumw = 0.;
+      for (unsigned int i = 0; i < tracks.size(); ++i) {
+	double wi = w[i];
+	if (iter > 0) {
+	  const double dt = tracks[i].timeExt() - t;
+	  wi /= 1. + std::exp(0.5*(dt*dt*inverr2[i] - chi2cutoff));
+	}
+	sumwt += wi*tracks[i].timeExt();
+	sumw  += wi;
+      }
+      if (!(sumw > 0.)) return false;
+      const double tnew = sumwt/sumw;
+      const bool converged = iter > 0 && std::abs(tnew - t) < 1.e-4;
+      t = tnew;
+      if (converged) break;
+    }
+    time = t;
+    timeError = std::sqrt(1./sumw);
+    return true;
+  }
+}
+
 PrimaryVertexProducer::PrimaryVertexProducer(const edm::ParameterSet& conf)
   :theConfig(conf)
 {
@@ -193,51 +236,25 @@ PrimaryVertexProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup
     for (std::vector< std::vector<reco::TransientTrack> >::const_iterator iclus
 	   = clusters.begin(); iclus != clusters.end(); iclus++) {
       
-      double meantime = 0.;
-      double expv_x2 = 0.;
-      double normw = 0.;  
-      if( f4D ) {
-        for( const auto& tk : *iclus ) {
-          const double time = tk.timeExt();
-          const double inverr = 1.0/tk.dtErrorExt();
-          const double w = inverr*inverr;
-          meantime += time*w;
-          expv_x2  += time*time*w;
-          normw    += w;
-        }
-        meantime = meantime/normw;
-        expv_x2 = expv_x2/normw;
-      }
-      const double time_var = ( f4D ? expv_x2 - meantime*meantime : 0. ); 
-
-
       TransientVertex v; 
       if( algorithm->useBeamConstraint && validBS &&((*iclus).size()>1) ){
         
 	v = algorithm->fitter->vertex(*iclus, beamSpot);
 	
-        if( f4D ) {
-          if( v.isValid() ) {
-            auto err = v.positionError().matrix4D();
-            err(3,3) = time_var/(double)iclus->size();        
-            v = TransientVertex(v.position(),meantime,err,v.originalTracks(),v.totalChiSquared());
-          }
-        }
-	
       }else if( !(algorithm->useBeamConstraint) && ((*iclus).size()>1) ) {
               
 	v = algorithm->fitter->vertex(*iclus);
         
-        if( f4D ) {
-          if( v.isValid() ) {
-            auto err = v.positionError().matrix4D();
-            err(3,3) = time_var/(double)iclus->size();          
-            v = TransientVertex(v.position(),meantime,err,v.originalTracks(),v.totalChiSquared());
-          }
-        }
-	
       }// else: no fit ==> v.isValid()=False
 
+      // the time is fitted after the position, using the weights of the tracks in the fit
+      double time = 0., timeError = 0.;
+      if( f4D && v.isValid() && fitVertexTime(v, time, timeError) ) {
+        auto err = v.positionError().matrix4D();
+        err(3,3) = timeError*timeError;
+        v = TransientVertex(v.position(),time,err,v.originalTracks(),v.totalChiSquared());
+      }
+
 
       if (fVerbose){
 	if (v.isValid()) {
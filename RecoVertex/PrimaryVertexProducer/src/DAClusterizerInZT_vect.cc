@@ -10,6 +10,8 @@
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
 
+#include "tbb/parallel_for.h"
+
 using namespace std;
 //#define VI_DEBUG
 
@@ -187,91 +189,102 @@ double DAClusterizerInZT_vect::update(double beta, track_t & gtracks,
       Z_init = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_); // cut-off
     }
   
-  // define kernels
-  auto kernel_calc_exp_arg = [ beta, nv ] ( const unsigned int itrack,
-					     track_t const& tracks,
-					     vertex_t const& vertices ) {
-    
-    const auto track_z = tracks.z_[itrack];
-    const auto track_t = tracks.t_[itrack];
-    const auto botrack_dz2 = -beta*tracks.dz2_[itrack];
-    const auto botrack_dt2 = -beta*tracks.dt2_[itrack];
-
-    // auto-vectorized
-    for ( unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
-      const auto mult_resz = track_z - vertices.z_[ivertex];
-      const auto mult_rest = track_t - vertices.t_[ivertex];
-      vertices.ei_cache_[ivertex] = botrack_dz2 * ( mult_resz * mult_resz ) + botrack_dt2 * ( mult_rest * mult_rest );
-    }
-  };
-  
-  auto kernel_add_Z = [ nv, Z_init ] (vertex_t const& vertices) -> double
-    {
-      double ZTemp = Z_init;
-      for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {	
-	ZTemp += vertices.pk_[ivertex] * vertices.ei_[ivertex];
+  // the tracks are processed in blocks of fixed size, each block summing into
+  // its own arrays; the blocks are then added in order, so that the result
+  // does not depend on the number of threads
+  constexpr unsigned int blockSize = 128;
+  constexpr unsigned int nsums = 8;
+  const unsigned int nb = (nt + blockSize - 1) / blockSize;
+  std::vector<double> scratch(nb * (nsums + 2) * nv);
+  std::vector<double> block_sumpi(nb, 0.);
+
+  auto kernel_block = [ beta, nt, nv, Z_init, &scratch, &block_sumpi, &gtracks, &gvertices ] (const unsigned int iblock) {
+    double * __restrict__ ei_cache = &scratch[iblock * (nsums + 2) * nv];
+    double * __restrict__ ei = ei_cache + nv;
+    double * __restrict__ se = ei + nv;
+    double * __restrict__ nuz = se + nv;
+    double * __restrict__ nut = nuz + nv;
+    double * __restrict__ swz = nut + nv;
+    double * __restrict__ swt = swz + nv;
+    double * __restrict__ szz = swt + nv;
+    double * __restrict__ stt = szz + nv;
+    double * __restrict__ szt = stt + nv;
+    const double * __restrict__ vz = gvertices.z_;
+    const double * __restrict__ vt = gvertices.t_;
+    const double * __restrict__ pk = gvertices.pk_;
+
+    double sumpi = 0;
+    const unsigned int last = std::min(nt, (iblock + 1) * blockSize);
+    for (auto itrack = iblock * blockSize; itrack < last; ++itrack) {
+      const auto track_z = gtracks.z_[itrack];
+      const auto track_t = gtracks.t_[itrack];
+      const auto botrack_dz2 = -beta*gtracks.dz2_[itrack];
+      const auto botrack_dt2 = -beta*gtracks.dt2_[itrack];
+
+      // auto-vectorized
+      for (unsigned int k = 0; k < nv; ++k) {
+	const auto mult_resz = track_z - vz[k];
+	const auto mult_rest = track_t - vt[k];
+	ei_cache[k] = botrack_dz2 * ( mult_resz * mult_resz ) + botrack_dt2 * ( mult_rest * mult_rest );
+      }
+      local_exp_list(ei_cache, ei, nv);
+
+      double Z_sum = Z_init;
+      for (unsigned int k = 0; k < nv; ++k) {
+	Z_sum += pk[k] * ei[k];
+      }
+      if (edm::isNotFinite(Z_sum)) Z_sum = 0.0;
+      gtracks.Z_sum_[itrack] = Z_sum;
+      // used in the next major loop to follow
+      sumpi += gtracks.pi_[itrack];
+
+      if (Z_sum > 1.e-100) {
+	auto tmp_trk_pi = gtracks.pi_[itrack];
+	auto o_trk_Z_sum = 1./Z_sum;
+	auto o_trk_err_z = gtracks.dz2_[itrack];
+	auto o_trk_err_t = gtracks.dt2_[itrack];
+
+	// auto-vectorized
+	for (unsigned int k = 0; k < nv; ++k) {
+	  // parens are important for numerical stability
+	  se[k] +=  tmp_trk_pi*( ei[k] * o_trk_Z_sum );
+	  const auto w = tmp_trk_pi * (pk[k] * ei[k] * o_trk_Z_sum);  // p_{ik}
+	  const auto wz = w * o_trk_err_z;
+	  const auto wt = w * o_trk_err_t;
+	  nuz[k] += wz;
+	  nut[k] += wt;
+	  swz[k] += wz * track_z;
+	  swt[k] += wt * track_t;
+	  /* this is really only needed when we want to get Tc too, mayb better to do it elsewhere? */
+	  const auto dsz = (track_z - vz[k]) * o_trk_err_z;
+	  const auto dst = (track_t - vt[k]) * o_trk_err_t;
+	  szz[k] += w * dsz * dsz;
+	  stt[k] += w * dst * dst;
+	  szt[k] += w * dsz * dst;
+	}
       }
-      return ZTemp;
-    };
-
-  auto kernel_calc_normalization = [ beta, nv ] (const unsigned int track_num,
-						  track_t & tks_vec,
-						  vertex_t & y_vec ) {
-    auto tmp_trk_pi = tks_vec.pi_[track_num];
-    auto o_trk_Z_sum = 1./tks_vec.Z_sum_[track_num];
-    auto o_trk_err_z = tks_vec.dz2_[track_num];
-    auto o_trk_err_t = tks_vec.dt2_[track_num];
-    auto tmp_trk_z = tks_vec.z_[track_num];
-    auto tmp_trk_t = tks_vec.t_[track_num];
-
-
-    // auto-vectorized
-    for (unsigned int k = 0; k < nv; ++k) {
-      // parens are important for numerical stability
-      y_vec.se_[k] +=  tmp_trk_pi*( y_vec.ei_[k] * o_trk_Z_sum );      
-      const auto w = tmp_trk_pi * (y_vec.pk_[k] * y_vec.ei_[k] * o_trk_Z_sum);  // p_{ik}
-      const auto wz = w * o_trk_err_z; 
-      const auto wt = w * o_trk_err_t; 
-      y_vec.nuz_[k] += wz;
-      y_vec.nut_[k] += wt;
-      y_vec.swz_[k] += wz * tmp_trk_z;
-      y_vec.swt_[k] += wt * tmp_trk_t;
-      /* this is really only needed when we want to get Tc too, mayb better to do it elsewhere? */
-      const auto dsz = (tmp_trk_z - y_vec.z[k]) * o_trk_err_z;
-      const auto dst = (tmp_trk_t - y_vec.t[k]) * o_trk_err_t;
-      y_vec.szz_[k] += w * dsz * dsz;
-      y_vec.stt_[k] += w * dst * dst;
-      y_vec.szt_[k] += w * dsz * dst;
     }
+    block_sumpi[iblock] = sumpi;
   };
-  
-  
-  for (auto ivertex = 0U; ivertex < nv; ++ivertex) {
-    gvertices.se_[ivertex] = 0.0;
-    gvertices.nuz_[ivertex] = 0.0;
-    gvertices.nut_[ivertex] = 0.0;
-    gvertices.swz_[ivertex] = 0.0;
-    gvertices.swt_[ivertex] = 0.0;
-    gvertices.szz_[ivertex] = 0.0;
-    gvertices.stt_[ivertex] = 0.0;
-    gvertices.szt_[ivertex] = 0.0;
+
+  if (nb > 1) {
+    tbb::parallel_for(0U, nb, kernel_block);
+  } else if (nb == 1) {
+    kernel_block(0);
   }
-  
-   
-  // loop over tracks
-  for (auto itrack = 0U; itrack < nt; ++itrack) {
-    kernel_calc_exp_arg(itrack, gtracks, gvertices);
-    local_exp_list(gvertices.ei_cache_, gvertices.ei_, nv);
-        
-    gtracks.Z_sum_[itrack] = kernel_add_Z(gvertices);
-    if (edm::isNotFinite(gtracks.Z_sum_[itrack])) gtracks.Z_sum_[itrack] = 0.0;
-    // used in the next major loop to follow
-    sumpi += gtracks.pi_[itrack];
-    
-    if (gtracks.Z_sum_[itrack] > 1.e-100){
-      kernel_calc_normalization(itrack, gtracks, gvertices);
+
+  // add the blocks in order
+  double * sums[nsums] = { gvertices.se_, gvertices.nuz_, gvertices.nut_, gvertices.swz_,
+			   gvertices.swt_, gvertices.szz_, gvertices.stt_, gvertices.szt_ };
+  for (auto isum = 0U; isum < nsums; ++isum) {
+    double * __restrict__ sum = sums[isum];
+    for (auto ivertex = 0U; ivertex < nv; ++ivertex) sum[ivertex] = 0.0;
+    for (auto iblock = 0U; iblock < nb; ++iblock) {
+      const double * __restrict__ block = &scratch[(iblock * (nsums + 2) + 2 + isum) * nv];
+      for (auto ivertex = 0U; ivertex < nv; ++ivertex) sum[ivertex] += block[ivertex];
     }
   }
+  for (auto iblock = 0U; iblock < nb; ++iblock) sumpi += block_sumpi[iblock];
   
   // now update z, t, and pk
   auto kernel_calc_zt = [  sumpi, nv, this, useRho0 ] (vertex_t & vertices ) -> double {
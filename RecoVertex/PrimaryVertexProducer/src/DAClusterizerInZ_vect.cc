@@ -3,6 +3,7 @@
 #include "DataFormats/GeometryCommonDetAlgo/interface/Measurement1D.h"
 #include "RecoVertex/VertexPrimitives/interface/VertexException.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <limits>
@@ -10,6 +11,8 @@
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
 
+#include "tbb/parallel_for.h"
+
 using namespace std;
 
 DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
@@ -162,71 +165,92 @@ double DAClusterizerInZ_vect::update(double beta, track_t & gtracks,
       Z_init = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_); // cut-off
     }
   
-  // define kernels
-  auto kernel_calc_exp_arg = [ beta, nv ] ( const unsigned int itrack,
-					     track_t const& tracks,
-					     vertex_t const& vertices ) {
-    const double track_z = tracks._z[itrack];
-    const double botrack_dz2 = -beta*tracks._dz2[itrack];
-
-    // auto-vectorized
-    for ( unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
-      auto mult_res =  track_z - vertices._z[ivertex];
-      vertices._ei_cache[ivertex] = botrack_dz2 * ( mult_res * mult_res );
-    }
-  };
-  
-  auto kernel_add_Z = [ nv, Z_init ] (vertex_t const& vertices) -> double
-    {
-      double ZTemp = Z_init;
-      for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {	
-	ZTemp += vertices._pk[ivertex] * vertices._ei[ivertex];
+  // the tracks are processed in blocks of fixed size, each block summing into
+  // its own arrays; the blocks are then added in order, so that the result
+  // does not depend on the number of threads
+  constexpr unsigned int blockSize = 128;
+  const unsigned int nb = (nt + blockSize - 1) / blockSize;
+  auto & scratch = gvertices.blockSums;
+  if (scratch.size() < nb * (6 * nv + 1)) scratch.resize(nb * (6 * nv + 1));
+  double * block_sumpi = &scratch[nb * 6 * nv];
+
+  auto kernel_block = [ beta, nt, nv, Z_init, &scratch, block_sumpi, &gtracks, &gvertices ] (const unsigned int iblock) {
+    double * __restrict__ ei_cache = &scratch[iblock * 6 * nv];
+    double * __restrict__ ei = ei_cache + nv;
+    double * __restrict__ se = ei + nv;
+    double * __restrict__ sw = se + nv;
+    double * __restrict__ swz = sw + nv;
+    double * __restrict__ swE = swz + nv;
+    std::fill(se, se + 4 * nv, 0.);
+    const double * __restrict__ vz = gvertices._z;
+    const double * __restrict__ pk = gvertices._pk;
+    auto obeta = -1./beta;
+
+    double sumpi = 0;
+    const unsigned int last = std::min(nt, (iblock + 1) * blockSize);
+    for (auto itrack = iblock * blockSize; itrack < last; ++itrack) {
+      const double track_z = gtracks._z[itrack];
+      const double botrack_dz2 = -beta*gtracks._dz2[itrack];
+
+      // auto-vectorized
+      for (unsigned int k = 0; k < nv; ++k) {
+	auto mult_res = track_z - vz[k];
+	ei_cache[k] = botrack_dz2 * ( mult_res * mult_res );
+      }
+      local_exp_list(ei_cache, ei, nv);
+
+      double Z_sum = Z_init;
+      for (unsigned int k = 0; k < nv; ++k) {
+	Z_sum += pk[k] * ei[k];
+      }
+      if (edm::isNotFinite(Z_sum)) Z_sum = 0.0;
+      gtracks._Z_sum[itrack] = Z_sum;
+      // used in the next major loop to follow
+      sumpi += gtracks._pi[itrack];
+
+      if (Z_sum > 1.e-100) {
+	auto tmp_trk_pi = gtracks._pi[itrack];
+	auto o_trk_Z_sum = 1./Z_sum;
+	auto o_trk_dz2 = gtracks._dz2[itrack];
+
+	// auto-vectorized
+	for (unsigned int k = 0; k < nv; ++k) {
+	  se[k] +=  ei[k] * (tmp_trk_pi* o_trk_Z_sum);
+	  auto w = pk[k] * ei[k] * (tmp_trk_pi*o_trk_Z_sum *o_trk_dz2);
+	  sw[k]  += w;
+	  swz[k] += w * track_z;
+	  swE[k] += w * ei_cache[k]*obeta;
+	}
       }
-      return ZTemp;
-    };
-
-  auto kernel_calc_normalization = [ beta, nv ] (const unsigned int track_num,
-						  track_t & tks_vec,
-						  vertex_t & y_vec ) {
-    auto tmp_trk_pi = tks_vec._pi[track_num];
-    auto o_trk_Z_sum = 1./tks_vec._Z_sum[track_num];
-    auto o_trk_dz2 = tks_vec._dz2[track_num];
-    auto tmp_trk_z = tks_vec._z[track_num];
-    auto obeta =  -1./beta;
-    
-    // auto-vectorized
-    for (unsigned int k = 0; k < nv; ++k) {
-      y_vec._se[k] +=  y_vec._ei[k] * (tmp_trk_pi* o_trk_Z_sum);
-      auto w = y_vec._pk[k] * y_vec._ei[k] * (tmp_trk_pi*o_trk_Z_sum *o_trk_dz2);
-      y_vec._sw[k]  += w;
-      y_vec._swz[k] += w * tmp_trk_z;
-      y_vec._swE[k] += w * y_vec._ei_cache[k]*obeta;
     }
+    block_sumpi[iblock] = sumpi;
   };
-  
-  
+
+  if (nb > 1) {
+    tbb::parallel_for(0U, nb, kernel_block);
+  } else if (nb == 1) {
+    kernel_block(0);
+  }
+
+  // add the blocks in order
   for (auto ivertex = 0U; ivertex < nv; ++ivertex) {
     gvertices._se[ivertex] = 0.0;
     gvertices._sw[ivertex] = 0.0;
     gvertices._swz[ivertex] = 0.0;
     gvertices._swE[ivertex] = 0.0;
   }
-  
-  
-  
-  // loop over tracks
-  for (auto itrack = 0U; itrack < nt; ++itrack) {
-    kernel_calc_exp_arg(itrack, gtracks, gvertices);
-    local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
-    
-    gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
-    if (edm::isNotFinite(gtracks._Z_sum[itrack])) gtracks._Z_sum[itrack] = 0.0;
-    // used in the next major loop to follow
-    sumpi += gtracks._pi[itrack];
-    
-    if (gtracks._Z_sum[itrack] > 1.e-100){
-      kernel_calc_normalization(itrack, gtracks, gvertices);
+  for (auto iblock = 0U; iblock < nb; ++iblock) {
+    const double * __restrict__ se = &scratch[iblock * 6 * nv + 2 * nv];
+    const double * __restrict__ sw = se + nv;
+    const double * __restrict__ swz = sw + nv;
+    const double * __restrict__ swE = swz + nv;
+    for (auto ivertex = 0U; ivertex < nv; ++ivertex) {
+      gvertices._se[ivertex] += se[ivertex];
+      gvertices._sw[ivertex] += sw[ivertex];
+      gvertices._swz[ivertex] += swz[ivertex];
+      gvertices._swE[ivertex] += swE[ivertex];
     }
+    sumpi += block_sumpi[iblock];
   }
   
   // now update z and pk
@@ -329,27 +353,34 @@ DAClusterizerInZ_vect::purge(vertex_t & y, track_t & tks, double & rho0, const d
   double sumpmin = nt;
   unsigned int k0 = nv;
   
-  for (unsigned int k = 0; k < nv; k++) {
-    
-    int nUnique = 0;
-    double sump = 0;
-
+  // the vertices are independent: they are evaluated in parallel,
+  // and the one to eliminate is chosen in order afterwards
+  std::vector<int> nUnique(nv, 0);
+  std::vector<double> sump(nv, 0.);
+  auto kernel_vertex = [ &, nt ] (const unsigned int k) {
     double pmax = y._pk[k] / (y._pk[k] + rho0 * local_exp(-beta * dzCutOff_* dzCutOff_));
+    // summed locally, the neighbouring vertices share the cache lines of sump and nUnique
+    double sumpk = 0;
+    int nUniquek = 0;
     for (unsigned int i = 0; i < nt; i++) {
       if (tks._Z_sum[i] > 1.e-100) {
 	double p = y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i])) / tks._Z_sum[i];
-	sump += p;
+	sumpk += p;
 	if ((p > uniquetrkweight_ * pmax) && (tks._pi[i] > 0)) {
-	  nUnique++;
+	  nUniquek++;
 	}
       }
     }
+    sump[k] = sumpk;
+    nUnique[k] = nUniquek;
+  };
+  tbb::parallel_for(0U, nv, kernel_vertex);
 
-    if ((nUnique < 2) && (sump < sumpmin)) {
-      sumpmin = sump;
+  for (unsigned int k = 0; k < nv; k++) {
+    if ((nUnique[k] < 2) && (sump[k] < sumpmin)) {
+      sumpmin = sump[k];
       k0 = k;
     }
-
   }
   
   if (k0 != nv) {
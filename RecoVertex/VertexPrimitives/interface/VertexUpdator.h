@@ -32,6 +32,31 @@ public:
   virtual CachingVertex<N> remove(const CachingVertex<N> & v,
 	const typename CachingVertex<N>::RefCountedVertexTrack  t) const = 0;
 
+  /**
+   * Method updating only the vertex state and chi2 with the track,
+   * for fitters adding many tracks in sequence: they can build the
+   * track container of the CachingVertex once, instead of copying
+   * it at each update. priorState is the prior of the vertex, or null
+   * for a vertex without prior. Returns false, leaving the new state
+   * and chi2 untouched, in case of problems during the update.
+   * The default implementation goes through add(), on a vertex without
+   * tracks but with the same prior.
+   */
+  virtual bool addToState(const VertexState & oldState, float oldChi2,
+	const VertexState * priorState,
+	const typename CachingVertex<N>::RefCountedVertexTrack  t,
+	VertexState & newState, float & newChi2) const
+  {
+    std::vector<RefCountedVertexTrack> noTracks;
+    CachingVertex<N> v = priorState ?
+      add(CachingVertex<N>(*priorState, oldState, noTracks, oldChi2), t) :
+      add(CachingVertex<N>(oldState, noTracks, oldChi2), t);
+    if (!v.isValid()) return false;
+    newState = v.vertexState();
+    newChi2 = v.totalChiSquared();
+    return true;
+  }
+
   virtual VertexUpdator * clone() const = 0;  
 
 };
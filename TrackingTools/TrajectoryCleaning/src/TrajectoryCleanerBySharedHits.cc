@@ -24,13 +24,24 @@ struct HashByDetId : std::unary_function<const TransientTrackingRecHit *, std::s
     }
 };
 
-using RecHitMap = cmsutil::SimpleAllocHashMultiMap<const TransientTrackingRecHit*, Trajectory *, HashByDetId, EqualsBySharesInput>;
-using TrajMap = cmsutil::UnsortedDumbVectorMap<Trajectory*, int>;
+// the values are the positions of the trajectories in the container
+using RecHitMap = cmsutil::SimpleAllocHashMultiMap<const TransientTrackingRecHit*, unsigned int, HashByDetId, EqualsBySharesInput>;
+
+// number of hits shared with each other trajectory, indexed by position:
+// constant time per shared hit, and the trajectories sharing hits are
+// kept in the order they are first found
+struct SharedCounts {
+  void reset(unsigned int n) { counts.assign(n,0); found.clear(); }
+  void add(unsigned int i) { if (0==counts[i]++) found.push_back(i); }
+  void clear() { for (auto i : found) counts[i]=0; found.clear(); }
+  std::vector<int> counts;
+  std::vector<unsigned int> found;
+};
 
 struct Maps {
   Maps() : theRecHitMap(128,256,1024){} // allocate 128 buckets, one row for 256 keys and one row for 512 values
   RecHitMap theRecHitMap;
-  TrajMap theTrajMap;
+  SharedCounts theSharedCounts;
 };
 
 thread_local Maps theMaps;
@@ -48,26 +59,29 @@ void TrajectoryCleanerBySharedHits::clean( TrajectoryPointerContainer & tc) cons
                                               // numbers are not optimized
 
   DEBUG_PRINT(std::cout << "Filling RecHit map" << std::endl);
-  for (auto const & it : tc) {
+  for (unsigned int i = 0; i < tc.size(); ++i) {
+    auto it = tc[i];
     DEBUG_PRINT(std::cout << "  Processing trajectory " << it << " (" << it->foundHits() << " valid hits)" << std::endl);
     auto const & pd = it->measurements();
     for (auto const & im : pd) {
       auto theRecHit = &(*im.recHit());
       if (theRecHit->isValid()) {
         DEBUG_PRINT(std::cout << "    Added hit " << theRecHit << " for trajectory " << it << std::endl);
-        theRecHitMap.insert(theRecHit, it);
+        theRecHitMap.insert(theRecHit, i);
       }
     }
   }
   DEBUG_PRINT(theRecHitMap.dump());
 
   DEBUG_PRINT(std::cout << "Using RecHit map" << std::endl);
-  // for each trajectory fill theTrajMap
-  auto & theTrajMap = theMaps.theTrajMap; 
-  for (auto const & itt : tc) {
+  // for each trajectory count the hits shared with the others
+  auto & theSharedCounts = theMaps.theSharedCounts;
+  theSharedCounts.reset(tc.size());
+  for (unsigned int i = 0; i < tc.size(); ++i) {
+    auto itt = tc[i];
     if(itt->isValid()){  
       DEBUG_PRINT(std::cout << "  Processing trajectory " << itt << " (" << itt->foundHits() << " valid hits)" << std::endl);
-      theTrajMap.clear();
+      theSharedCounts.clear();
       const Trajectory::DataContainer & pd = itt->measurements();
       for (auto const & im : pd) {
 	auto theRecHit = &(*im.recHit());
@@ -75,15 +89,15 @@ void TrajectoryCleanerBySharedHits::clean( TrajectoryPointerContainer & tc) cons
           DEBUG_PRINT(std::cout << "    Searching for overlaps on hit " << theRecHit << " for trajectory " << itt << std::endl);
           for (RecHitMap::value_iterator ivec = theRecHitMap.values(theRecHit);
                 ivec.good(); ++ivec) {
-              if (*ivec != itt){
-                if ((*ivec)->isValid()){
-                    theTrajMap[*ivec]++;
+              if (tc[*ivec] != itt){
+                if (tc[*ivec]->isValid()){
+                    theSharedCounts.add(*ivec);
                 }
               }
           }
 	}
       }
-      //end filling theTrajMap
+      //end counting the shared hits
 
      auto score = [&](Trajectory const&t)->float {
             // possible variant under study
@@ -95,34 +109,32 @@ void TrajectoryCleanerBySharedHits::clean( TrajectoryPointerContainer & tc) cons
      };
 
       // check for duplicated tracks
-      if(!theTrajMap.empty() > 0){
-	for(auto const & imapp : theTrajMap) {
-	  if(imapp.second > 0 ){  // at least 1 hits in common!!!
-	    int innerHit = 0;
-	    if ( allowSharedFirstHit ) {
-	      const TrajectoryMeasurement & innerMeasure1 = ( itt->direction() == alongMomentum ) ? 
-		itt->firstMeasurement() : itt->lastMeasurement();
-	      const TransientTrackingRecHit* h1 = &(*(innerMeasure1).recHit());
-	      const TrajectoryMeasurement & innerMeasure2 = ( imapp.first->direction() == alongMomentum ) ? 
-		imapp.first->firstMeasurement() : imapp.first->lastMeasurement();
-	      const TransientTrackingRecHit* h2 = &(*(innerMeasure2).recHit());
-	      if ( (h1 == h2) || ((h1->geographicalId() == h2->geographicalId()) && 
-				  (h1->hit()->sharesInput(h2->hit(), TrackingRecHit::some))) ) {
-		innerHit = 1;
-	      }
-	    }
-	    int nhit1 = itt->foundHits();
-	    int nhit2 = imapp.first->foundHits();
-	    if( (imapp.second - innerHit) >= ( (min(nhit1, nhit2)-innerHit) * theFraction) ){
-	      Trajectory* badtraj;
-	      auto score1 = score(*itt);
-	      auto score2 = score(*imapp.first);
-	      badtraj = (score1 > score2) ? imapp.first : itt;
-	      badtraj->invalidate();  // invalidate this trajectory
-	    }
+      for(auto j : theSharedCounts.found) {
+	auto other = tc[j];
+	auto nShared = theSharedCounts.counts[j];  // at least 1 hits in common!!!
+	int innerHit = 0;
+	if ( allowSharedFirstHit ) {
+	  const TrajectoryMeasurement & innerMeasure1 = ( itt->direction() == alongMomentum ) ? 
+	    itt->firstMeasurement() : itt->lastMeasurement();
+	  const TransientTrackingRecHit* h1 = &(*(innerMeasure1).recHit());
+	  const TrajectoryMeasurement & innerMeasure2 = ( other->direction() == alongMomentum ) ? 
+	    other->firstMeasurement() : other->lastMeasurement();
+	  const TransientTrackingRecHit* h2 = &(*(innerMeasure2).recHit());
+	  if ( (h1 == h2) || ((h1->geographicalId() == h2->geographicalId()) && 
+			      (h1->hit()->sharesInput(h2->hit(), TrackingRecHit::some))) ) {
+	    innerHit = 1;
 	  }
 	}
-      } 
+	int nhit1 = itt->foundHits();
+	int nhit2 = other->foundHits();
+	if( (nShared - innerHit) >= ( (min(nhit1, nhit2)-innerHit) * theFraction) ){
+	  Trajectory* badtraj;
+	  auto score1 = score(*itt);
+	  auto score2 = score(*other);
+	  badtraj = (score1 > score2) ? other : itt;
+	  badtraj->invalidate();  // invalidate this trajectory
+	}
+      }
     }
   }
 }